@@ -0,0 +1,53 @@
+# Links only the registrations an executable uses out of static libraries,
+# see cppregpattern/anchor.h.
+#
+#   cppregpattern_use_registrations(<target>
+#     [ANCHORS <name>...]
+#     [ANCHORS_FILE <file>])
+#
+# Generates <target>_registrations.cpp, which references the given anchors
+# with CPPREGPATTERN_USE_ANCHOR(), adds it to <target>, and writes the list
+# of anchors used to <target>_registrations.txt in the current binary
+# directory. ANCHORS_FILE names a file with one anchor per line; empty lines
+# and lines starting with '#' are ignored. <target> must link to
+# cppregpattern::cppregpattern.
+function(cppregpattern_use_registrations target)
+  cmake_parse_arguments(ARG "" "ANCHORS_FILE" "ANCHORS" ${ARGN})
+
+  set(anchors ${ARG_ANCHORS})
+  if (ARG_ANCHORS_FILE)
+    get_filename_component(anchors_file "${ARG_ANCHORS_FILE}" ABSOLUTE)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS
+                 "${anchors_file}")
+    file(STRINGS "${anchors_file}" lines)
+    foreach(line IN LISTS lines)
+      string(STRIP "${line}" line)
+      if (line AND NOT line MATCHES "^#")
+        list(APPEND anchors "${line}")
+      endif()
+    endforeach()
+  endif()
+  if (anchors)
+    list(REMOVE_DUPLICATES anchors)
+  endif()
+
+  set(source "// Generated by cppregpattern_use_registrations(); do not edit.\n")
+  string(APPEND source "#include \"cppregpattern/anchor.h\"\n\n")
+  set(listing "")
+  foreach(anchor IN LISTS anchors)
+    if (NOT anchor MATCHES "^[A-Za-z_][A-Za-z0-9_]*$")
+      message(FATAL_ERROR "cppregpattern_use_registrations: invalid anchor "
+                          "name '${anchor}'")
+    endif()
+    string(APPEND source "CPPREGPATTERN_USE_ANCHOR(${anchor});\n")
+    string(APPEND listing "${anchor}\n")
+  endforeach()
+
+  # Only touch the outputs when they change, to avoid needless rebuilds
+  set(prefix "${CMAKE_CURRENT_BINARY_DIR}/${target}_registrations")
+  file(WRITE "${prefix}.cpp.tmp" "${source}")
+  file(WRITE "${prefix}.txt.tmp" "${listing}")
+  configure_file("${prefix}.cpp.tmp" "${prefix}.cpp" COPYONLY)
+  configure_file("${prefix}.txt.tmp" "${prefix}.txt" COPYONLY)
+  target_sources(${target} PRIVATE "${prefix}.cpp")
+endfunction()
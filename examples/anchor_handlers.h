@@ -0,0 +1,37 @@
+// The registry filled by the generated handler groups of the anchor_report
+// target, see examples/CMakeLists.txt.
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "cppregpattern/anchor.h"
+#include "cppregpattern/registry.h"
+
+using AnchorHandlers = registry::Registry<std::string, int(int)>;
+
+constexpr int kHandlersPerGroup = 32;
+
+inline std::string HandlerKey(int group, int handler) {
+  return "h" + std::to_string(group) + "_" + std::to_string(handler);
+}
+
+template <int Group, int Handler>
+int Handle(int x) {
+  return x * (Group + 1) + Handler;
+}
+
+template <int Group, int... Handler>
+bool RegisterHandlers(std::integer_sequence<int, Handler...>) {
+  return (AnchorHandlers::Register(HandlerKey(Group, Handler),
+                                   &Handle<Group, Handler>) &
+          ...);
+}
+
+/// Registers the handlers of group `Group`, from its own object file
+template <int Group>
+bool RegisterHandlers() {
+  return RegisterHandlers<Group>(
+      std::make_integer_sequence<int, kHandlersPerGroup>());
+}
@@ -0,0 +1,20 @@
+// Checks which handler groups of the anchor_report target were linked in:
+// groups 0 and 1, which are anchored, and all others only when the library
+// is linked with --whole-archive (ANCHOR_WHOLE_ARCHIVE).
+
+#include <iostream>
+
+#include "anchor_handlers.h"
+
+int main() {
+  for (int group = 0; group < ANCHOR_GROUPS; ++group) {
+    bool expected = group < 2 || ANCHOR_WHOLE_ARCHIVE;
+    if (AnchorHandlers::IsRegistered(HandlerKey(group, 0)) != expected) {
+      std::cerr << "handler group " << group
+                << (expected ? " is missing" : " should not be linked")
+                << std::endl;
+      return 1;
+    }
+  }
+  return AnchorHandlers::Dispatch(HandlerKey(1, 3), 1) == 5 ? 0 : 1;
+}
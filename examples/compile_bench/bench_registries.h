@@ -0,0 +1,33 @@
+// The registries shared by the generated sources of the compile-time
+// benchmark. BENCH_EXTERN declares their instantiations extern (see
+// instantiate.cpp), BENCH_MODULE imports the library instead of including it.
+
+#pragma once
+
+#ifdef BENCH_MODULE
+import cppregpattern;
+#include <memory>
+#include <string>
+#else
+#include <memory>
+#include <string>
+
+#include "cppregpattern/registry.h"
+#endif
+
+struct Shape {
+  virtual ~Shape() = default;
+  virtual double Area() const = 0;
+};
+
+using Ints = registry::Registry<std::string, int(int)>;
+using Names = registry::Registry<std::string, std::string(const std::string&)>;
+using Shapes = registry::Registry<std::string, std::unique_ptr<Shape>(double)>;
+using Checks = registry::Registry<std::string, bool(int, int)>;
+
+#ifdef BENCH_EXTERN
+CPPREGPATTERN_EXTERN_REGISTRY(std::string, int(int));
+CPPREGPATTERN_EXTERN_REGISTRY(std::string, std::string(const std::string&));
+CPPREGPATTERN_EXTERN_REGISTRY(std::string, std::unique_ptr<Shape>(double));
+CPPREGPATTERN_EXTERN_REGISTRY(std::string, bool(int, int));
+#endif
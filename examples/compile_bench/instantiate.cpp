@@ -0,0 +1,10 @@
+// Compiles the registries declared extern by bench_registries.h once.
+
+#include "bench_registries.h"
+
+CPPREGPATTERN_INSTANTIATE_REGISTRY(std::string, int(int));
+CPPREGPATTERN_INSTANTIATE_REGISTRY(std::string,
+                                   std::string(const std::string&));
+CPPREGPATTERN_INSTANTIATE_REGISTRY(std::string,
+                                   std::unique_ptr<Shape>(double));
+CPPREGPATTERN_INSTANTIATE_REGISTRY(std::string, bool(int, int));
@@ -0,0 +1,23 @@
+# Builds each of TARGETS from scratch in BUILD_DIR, one job at a time, and
+# prints the wall-clock time it took.
+#
+#   cmake -DBUILD_DIR=<dir> -DTARGETS=<target>[;<target>...] -P time_build.cmake
+cmake_minimum_required(VERSION 3.23)
+
+foreach(target IN LISTS TARGETS)
+  execute_process(COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --target clean
+                  RESULT_VARIABLE result OUTPUT_QUIET)
+  if (result)
+    message(FATAL_ERROR "Cleaning ${BUILD_DIR} failed")
+  endif()
+  string(TIMESTAMP start "%s%f")
+  execute_process(COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR}
+                          --target ${target} --parallel 1
+                  RESULT_VARIABLE result OUTPUT_QUIET)
+  string(TIMESTAMP end "%s%f")
+  if (result)
+    message(FATAL_ERROR "Building ${target} failed")
+  endif()
+  math(EXPR elapsed_ms "(${end} - ${start}) / 1000")
+  message("${elapsed_ms} ms  ${target}")
+endforeach()
@@ -0,0 +1,106 @@
+// Measures the memory forked workers dirty when dispatching through a
+// FrozenRegistry, and checks that they never write to its functions.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cppregpattern/frozen_registry.h"
+
+using Handlers = registry::Registry<std::string, std::size_t(std::size_t)>;
+
+namespace {
+
+constexpr int kWorkers = 4;
+constexpr std::size_t kKeys = 20000;
+
+/// Returns the named field, in kB, of the mapping containing `address`, or
+/// of the whole process if `address` is null
+long Smaps(const void* address, const char* field) {
+  std::ifstream smaps(address ? "/proc/self/smaps"
+                              : "/proc/self/smaps_rollup");
+  std::uintptr_t target = reinterpret_cast<std::uintptr_t>(address);
+  bool inside = address == nullptr;
+  std::string line;
+  while (std::getline(smaps, line)) {
+    unsigned long begin, end;
+    if (std::sscanf(line.c_str(), "%lx-%lx ", &begin, &end) == 2) {
+      inside = address == nullptr || (begin <= target && target < end);
+    } else if (inside && line.compare(0, std::strlen(field), field) == 0) {
+      return std::stol(line.substr(std::strlen(field) + 1));
+    }
+  }
+  return -1;
+}
+
+/// Forks the workers, each dispatching every key, and returns the number of
+/// workers that dirtied memory in the mapping containing `region`. The
+/// kernel may merge that mapping with neighbouring ones, so only the pages
+/// dirtied while dispatching count.
+template <class Dispatch>
+int RunWorkers(const char* name, const std::vector<std::string>& keys,
+               const void* region, Dispatch dispatch) {
+  std::fflush(stdout);
+  for (int w = 0; w < kWorkers; ++w) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      long before = region ? Smaps(region, "Private_Dirty:") : 0;
+      std::size_t sum = 0;
+      for (int round = 0; round < 10; ++round) {
+        for (const std::string& key : keys) sum += dispatch(key, sum);
+      }
+      long rss = Smaps(nullptr, "Rss:");
+      long dirty = Smaps(nullptr, "Private_Dirty:");
+      long region_dirty =
+          region ? Smaps(region, "Private_Dirty:") - before : 0;
+      std::printf("%s worker %d: %ld kB RSS, %ld kB private dirty, "
+                  "%ld kB dirtied in the frozen functions (checksum %zx)\n",
+                  name, w, rss, dirty, region_dirty, sum);
+      std::fflush(stdout);
+      _exit(region_dirty == 0 ? 0 : 1);
+    }
+  }
+  int failed = 0;
+  for (int w = 0; w < kWorkers; ++w) {
+    int status = 0;
+    wait(&status);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failed;
+  }
+  return failed;
+}
+
+}
+
+int main() {
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < kKeys; ++i) {
+    keys.push_back("handler/with/a/long/name/" + std::to_string(i));
+    Handlers::Register(keys.back(), [i](std::size_t x) { return x ^ i; });
+  }
+  Handlers::Seal();
+  const registry::FrozenRegistry<Handlers::instance_t> frozen(
+      Handlers::Instance());
+
+  RunWorkers("registry", keys, nullptr,
+             [](const std::string& key, std::size_t x) {
+               return Handlers::Dispatch(key, x);
+             });
+  int failed = RunWorkers("frozen", keys, frozen.Find(keys.front()),
+                          [&frozen](const std::string& key, std::size_t x) {
+                            return frozen.Dispatch(key, x);
+                          });
+  if (failed != 0) {
+    std::fprintf(stderr, "%d workers wrote to the frozen functions\n", failed);
+    return 1;
+  }
+  std::printf("frozen regions: %zu kB + %zu kB shared by %d workers\n",
+              frozen.region_size() / 1024, frozen.funcs_region_size() / 1024,
+              kWorkers);
+  return 0;
+}
@@ -0,0 +1,25 @@
+// Checks that a FrozenRegistry dispatches to stateful callables, whose
+// calls update the state stored with the function.
+
+#include <iostream>
+#include <string>
+
+#include "cppregpattern/frozen_registry.h"
+
+using Counters = registry::Registry<std::string, int()>;
+
+int main() {
+  Counters::Register("count", [n = 0]() mutable { return ++n; });
+  Counters::Seal();
+  const registry::FrozenRegistry<Counters::instance_t> frozen(
+      Counters::Instance());
+
+  for (int expected = 1; expected <= 3; ++expected) {
+    int n = frozen.Dispatch("count");
+    if (n != expected) {
+      std::cerr << "call " << expected << " returned " << n << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Checks that the real-time verification mode reports allocations, locks
+// and exceptions on the dispatch path, and nothing for a real-time safe
+// registry. Built with CPPREGPATTERN_RT_VERIFY defined.
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "cppregpattern/fixed_registry.h"
+#include "cppregpattern/inline_cache.h"
+#include "cppregpattern/registry.h"
+
+CPPREGPATTERN_RT_VERIFY_OPERATOR_NEW()
+
+using registry::BasicRegistry;
+using registry::MissingKeyPolicy;
+namespace rt = registry::rt;
+
+using Gains = registry::FixedRegistry<int, double(double), 8>;
+using Filters = BasicRegistry<int, double(double)>;
+using SharedFilters =
+    BasicRegistry<int, double(double), MissingKeyPolicy::exception,
+                  std::hash<int>, std::equal_to<int>,
+                  std::allocator<std::pair<const int,
+                                           std::function<double(double)>>>,
+                  registry::SharedMutexPolicy>;
+using Handlers = BasicRegistry<std::string, int(int)>;
+
+namespace {
+
+double Half(double x) { return x / 2; }
+
+int failures = 0;
+
+void Expect(bool condition, const char* what) {
+  if (!condition) {
+    std::cerr << "FAILED: " << what << std::endl;
+    ++failures;
+  }
+}
+
+}
+
+int main() {
+  Gains::Register(1, &Half);
+  Filters filters;
+  filters.Register(1, [](double x) { return x * 3; });
+  filters.Register(2, [](double x) {
+    return x + static_cast<double>(std::string(64, 'x').size());
+  });
+  filters.Register(3, [](double) -> double {
+    throw std::runtime_error("overload");
+  });
+  SharedFilters shared;
+  shared.Register(1, [](double x) { return x; });
+  const std::string long_key(64, 'k');
+  Handlers handlers;
+  handlers.Register(long_key, [](int x) { return x; });
+  registry::CachedRegistry<Handlers> cached(handlers);
+
+  rt::Report report = rt::Check([] { Gains::Dispatch(1, 1.0); });
+  Expect(report.clean(), "FixedRegistry::Dispatch is real-time safe");
+
+  report = rt::Check([&] { filters.Dispatch(1, 1.0); });
+  Expect(report.clean(), "an allocation-free function is real-time safe");
+
+  report = rt::Check([&] { filters.Dispatch(2, 1.0); });
+  Expect(report.allocations > 0, "the allocation detector fires");
+
+  report = rt::Check([&] { shared.Dispatch(1, 1.0); });
+  Expect(report.locks == 1, "the lock detector fires for SharedMutexPolicy");
+
+  report = rt::Check([&] { filters.Dispatch(3, 1.0); });
+  Expect(report.exceptions == 1, "the exception detector fires");
+
+  report = rt::Check([&] { cached.Dispatch(long_key, 1); });
+  Expect(report.clean(), "CachedRegistry does not copy keys on a miss");
+
+  report = rt::Check([&] { std::string outside(64, 'y'); });
+  Expect(report.clean(), "work outside Dispatch is not checked");
+
+  return failures == 0 ? 0 : 1;
+}
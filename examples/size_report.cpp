@@ -0,0 +1,58 @@
+// A program with 150 registries over std::string keys, each with its own
+// function type, built twice by the size_report target: once with
+// BasicRegistry and once, with CPPREGPATTERN_SIZE_REPORT_STD, with a
+// std::unordered_map of std::function per registry, which instantiates the
+// map and its lookup for every function type.
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cppregpattern/registry.h"
+
+constexpr std::size_t kRegistries = 150;
+
+template <std::size_t N>
+struct Arg {
+  int value;
+};
+
+template <std::size_t N>
+int Twice(Arg<N> arg) {
+  return 2 * arg.value;
+}
+
+#ifdef CPPREGPATTERN_SIZE_REPORT_STD
+template <std::size_t N>
+int Use(const std::string& key, int value) {
+  static std::unordered_map<std::string, std::function<int(Arg<N>)>> table;
+  table[key] = &Twice<N>;
+  auto it = table.find(key);
+  return it == table.end() ? 0 : it->second(Arg<N>{value});
+}
+#else
+template <std::size_t N>
+int Use(const std::string& key, int value) {
+  static registry::BasicRegistry<std::string, int(Arg<N>)> table;
+  table.Register(key, &Twice<N>);
+  return table.Dispatch(key, Arg<N>{value});
+}
+#endif
+
+template <std::size_t... N>
+int UseAll(const std::string& key, std::index_sequence<N...>) {
+  return (Use<N>(key, 1) + ...);
+}
+
+int main(int argc, char** argv) {
+  std::string key = argc > 1 ? argv[1] : "twice";
+  int total = UseAll(key, std::make_index_sequence<kRegistries>());
+  if (total != 2 * static_cast<int>(kRegistries)) {
+    std::cerr << "unexpected total " << total << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+// Runs each program given on the command line many times and prints the
+// mean wall-clock time from spawning it to its exit.
+
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include <chrono>
+#include <cstdio>
+
+extern char** environ;
+
+int main(int argc, char** argv) {
+  constexpr int kRuns = 200;
+  for (int i = 1; i < argc; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < kRuns; ++run) {
+      char* args[] = {argv[i], nullptr};
+      pid_t pid;
+      if (posix_spawn(&pid, argv[i], nullptr, nullptr, args, environ) != 0) {
+        std::perror(argv[i]);
+        return 1;
+      }
+      int status = 0;
+      if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+          WEXITSTATUS(status) != 0) {
+        std::fprintf(stderr, "%s failed\n", argv[i]);
+        return 1;
+      }
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::printf("%10.1f us  %s\n", elapsed.count() / kRuns, argv[i]);
+  }
+  return 0;
+}
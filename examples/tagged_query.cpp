@@ -0,0 +1,28 @@
+// Checks that TaggedRegistry caches range queries by their exact bounds.
+
+#include <iostream>
+#include <string>
+
+#include "cppregpattern/tagged_registry.h"
+
+using Filters = registry::TaggedRegistry<std::string, int()>;
+
+int main() {
+  Filters::Register("tiny", [] { return 0; }, {{}, {{"x", 1e-7}}});
+
+  registry::TagQuery wide;
+  wide.ranges.push_back({"x", 0, 2e-7});
+  registry::TagQuery point;
+  point.ranges.push_back({"x", 0, 0});
+
+  // Bounds that print the same with 6 decimals must not share a cache entry
+  if (Filters::Select(wide)->size() != 1) {
+    std::cerr << "x in [0, 2e-7] should select \"tiny\"" << std::endl;
+    return 1;
+  }
+  if (!Filters::Select(point)->empty()) {
+    std::cerr << "x in [0, 0] should select nothing" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+/** Registration anchors for static libraries
+ *
+ *  \file anchor.h
+ *  \date 18 Oct 2026
+ *
+ *  The linker only takes an object file out of a static library if it
+ *  defines a symbol the program still needs, so an object file that only
+ *  registers functions from static initializers is dropped. Instead of
+ *  linking the whole library with `--whole-archive`, give each such object
+ *  file an anchor:
+ *
+ *  \code{.cpp}
+ *  // handlers/echo.cpp, in libhandlers.a
+ *  CPPREGPATTERN_ANCHOR(echo_handlers);
+ *  static bool registered = Handlers::Register("echo", &Echo);
+ *  \endcode
+ *
+ *  and reference the anchors of the registrations an executable needs, in
+ *  any one of its source files:
+ *
+ *  \code{.cpp}
+ *  CPPREGPATTERN_USE_ANCHOR(echo_handlers);
+ *  \endcode
+ *
+ *  Only those object files are linked in. An anchor covers all
+ *  registrations of its object file, the unit the linker works with. The
+ *  CMake function cppregpattern_use_registrations() generates the
+ *  CPPREGPATTERN_USE_ANCHOR() lines from a per-executable list.
+ */
+
+#pragma once
+
+/// Defines the anchor `name` in the current object file
+#define CPPREGPATTERN_ANCHOR(name)                   \
+  extern "C" const char cppregpattern_anchor_##name; \
+  extern "C" const char cppregpattern_anchor_##name = 0
+
+#if defined(_MSC_VER)
+/// Makes the linker keep the object file defining the anchor `name`
+#define CPPREGPATTERN_USE_ANCHOR(name) \
+  __pragma(comment(linker, "/include:cppregpattern_anchor_" #name))
+#else
+/// Makes the linker keep the object file defining the anchor `name`
+#define CPPREGPATTERN_USE_ANCHOR(name)                                \
+  extern "C" const char cppregpattern_anchor_##name;                  \
+  __attribute__((used)) static const char* const                      \
+      cppregpattern_use_anchor_##name = &cppregpattern_anchor_##name
+#endif
@@ -0,0 +1,209 @@
+/** Scoped arenas for objects created by registered factories
+ *
+ *  \file arena_scope.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace registry {
+
+/** Deleter of ArenaPtr: deletes objects allocated on the heap and leaves
+ *  objects owned by an ArenaScope to the scope
+ */
+template <class T>
+struct ArenaDeleter {
+  constexpr ArenaDeleter() noexcept = default;
+  explicit constexpr ArenaDeleter(bool arena) noexcept : in_arena(arena) {}
+
+  template <class U, class = typename std::enable_if<
+                         std::is_convertible<U*, T*>::value>::type>
+  ArenaDeleter(const ArenaDeleter<U>& other) noexcept  // NOLINT: implicit
+      : in_arena(other.in_arena) {}
+
+  void operator()(T* object) const {
+    if (!in_arena) delete object;
+  }
+
+  bool in_arena = false;
+};
+
+/// Owning pointer returned by factories that support ArenaScope
+template <class T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+/** An arena for the objects created while it is the innermost scope of its
+ *  thread. Factories that build their result with MakeArena() allocate it
+ *  from the innermost scope, if any, instead of the heap. When the scope
+ *  ends, objects of trivially destructible types are dropped, the others are
+ *  destroyed grouped by their concrete type (calling each type's destructor
+ *  directly rather than through the vtable), and the memory is released all
+ *  at once.
+ *
+ *  \code{.cpp}
+ *  using Nodes = Registry<std::string, ArenaPtr<Node>(const Config&)>;
+ *  Nodes::Register("leaf", [](const Config& c) {
+ *    return MakeArena<Leaf>(c);
+ *  });
+ *
+ *  void Handle(const Request& request) {
+ *    ArenaScope scope;
+ *    for (const auto& c : request.configs) Run(*Nodes::Dispatch(c.kind, c));
+ *  }  // All nodes destroyed here
+ *  \endcode
+ *
+ *  \par
+ *  Objects must not outlive the scope, and their destructors must not rely
+ *  on the order in which objects are destroyed. A scope is used by one
+ *  thread only and must end on the thread that created it.
+ */
+class ArenaScope {
+ public:
+  static constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+
+  explicit ArenaScope(std::size_t chunk_size = kDefaultChunkSize)
+      : chunk_size_(chunk_size), previous_(Current()) {
+    Current() = this;
+  }
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+  ~ArenaScope() {
+    Reset();
+    if (!chunks_.empty()) ::operator delete(chunks_.front().data);
+    Current() = previous_;
+  }
+
+  /// The innermost scope of the calling thread, or nullptr
+  static ArenaScope* Innermost() { return Current(); }
+
+  /// Constructs a `T` in the arena; the scope destroys it
+  template <class T, class... Args>
+  T* New(Args&&... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "ArenaScope does not support over-aligned types");
+    void* memory = Allocate(sizeof(T), alignof(T));
+    if (std::is_trivially_destructible<T>::value) {
+      T* object = ::new (memory) T(std::forward<Args>(args)...);
+      ++objects_;
+      return object;
+    }
+    // Reserve the object's slot first, so that a failing push_back cannot
+    // leave it undestroyed; the constructor may create other objects in
+    // this scope, so the slot is found again by its position
+    DestroyGroup& group = Group(&DestroyAll<T>);
+    std::size_t group_index = static_cast<std::size_t>(&group - &groups_[0]);
+    std::size_t slot = group.objects.size();
+    group.objects.push_back(nullptr);
+    T* object = ::new (memory) T(std::forward<Args>(args)...);
+    groups_[group_index].objects[slot] = object;
+    ++objects_;
+    return object;
+  }
+
+  /** Destroys all objects and releases the memory, keeping the first chunk
+   *  for reuse
+   */
+  void Reset() {
+    for (DestroyGroup& group : groups_) group.destroy(group.objects);
+    groups_.clear();
+    last_group_ = nullptr;
+    for (std::size_t i = 1; i < chunks_.size(); ++i) {
+      ::operator delete(chunks_[i].data);
+    }
+    if (chunks_.size() > 1) chunks_.resize(1);
+    used_ = 0;
+    objects_ = 0;
+  }
+
+  /// Number of objects created since the last Reset()
+  std::size_t objects() const { return objects_; }
+
+  /// Number of chunks currently held
+  std::size_t chunks() const { return chunks_.size(); }
+
+ private:
+  struct Chunk {
+    unsigned char* data;
+    std::size_t size;
+  };
+
+  struct DestroyGroup {
+    void (*destroy)(std::vector<void*>&);
+    std::vector<void*> objects;
+  };
+
+  static ArenaScope*& Current() {
+    thread_local ArenaScope* current = nullptr;
+    return current;
+  }
+
+  template <class T>
+  static void DestroyAll(std::vector<void*>& objects) {
+    // Qualified, so that the call is direct even for a virtual destructor;
+    // a null slot is left by a constructor that threw
+    for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+      if (*it != nullptr) static_cast<T*>(*it)->T::~T();
+    }
+  }
+
+  /// The group of objects destroyed by `destroy`; types are few per scope
+  DestroyGroup& Group(void (*destroy)(std::vector<void*>&)) {
+    if (last_group_ != nullptr && last_group_->destroy == destroy) {
+      return *last_group_;
+    }
+    for (DestroyGroup& group : groups_) {
+      if (group.destroy == destroy) return *(last_group_ = &group);
+    }
+    groups_.push_back(DestroyGroup{destroy, {}});
+    return *(last_group_ = &groups_.back());
+  }
+
+  void* Allocate(std::size_t size, std::size_t align) {
+    if (!chunks_.empty()) {
+      std::size_t offset = (used_ + align - 1) & ~(align - 1);
+      if (offset + size <= chunks_.back().size) {
+        used_ = offset + size;
+        return chunks_.back().data + offset;
+      }
+    }
+    std::size_t chunk_size = size > chunk_size_ ? size : chunk_size_;
+    chunks_.reserve(chunks_.size() + 1);
+    unsigned char* data =
+        static_cast<unsigned char*>(::operator new(chunk_size));
+    chunks_.push_back(Chunk{data, chunk_size});
+    used_ = size;
+    return data;
+  }
+
+  std::size_t chunk_size_;
+  ArenaScope* previous_;
+  std::vector<Chunk> chunks_;
+  std::size_t used_ = 0;  // Bytes used in the last chunk
+  std::vector<DestroyGroup> groups_;
+  DestroyGroup* last_group_ = nullptr;
+  std::size_t objects_ = 0;
+};
+
+/** Creates a `T` in the calling thread's innermost ArenaScope, or on the
+ *  heap if there is none. Either way, the result can be converted to an
+ *  ArenaPtr of a base class and returned from a registered factory.
+ */
+template <class T, class... Args>
+ArenaPtr<T> MakeArena(Args&&... args) {
+  if (ArenaScope* scope = ArenaScope::Innermost()) {
+    return ArenaPtr<T>(scope->New<T>(std::forward<Args>(args)...),
+                       ArenaDeleter<T>(true));
+  }
+  return ArenaPtr<T>(new T(std::forward<Args>(args)...));
+}
+
+}
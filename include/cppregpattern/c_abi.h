@@ -0,0 +1,183 @@
+/** Plain C dispatch tables for plugins built with other toolchains
+ *
+ *  \file c_abi.h
+ *  \date 18 Oct 2026
+ *
+ *  A plugin describes its functions with a cppregpattern_table: a versioned
+ *  header and an array of `{key, key_len, fn}` records, using only C types,
+ *  so it can be compiled by any C or C++ compiler against any standard
+ *  library. The host ingests the table with IngestCTable(), which registers
+ *  all records in one Commit().
+ *
+ *  \code{.c}
+ *  // Plugin, C or C++:
+ *  static int Add(int a, int b) { return a + b; }
+ *  static const cppregpattern_entry kEntries[] = {
+ *      CPPREGPATTERN_C_ENTRY("add", Add),
+ *  };
+ *  CPPREGPATTERN_C_TABLE(plugin_ops, "int(int,int)", kEntries);
+ *  \endcode
+ *
+ *  \code{.cpp}
+ *  // Host:
+ *  using Ops = BasicRegistry<std::string, int (*)(int, int)>;
+ *  auto* table = static_cast<const cppregpattern_table*>(
+ *      dlsym(plugin, "plugin_ops"));
+ *  registry::IngestCTable(ops, *table, "int(int,int)");
+ *  \endcode
+ *
+ *  The signature string is chosen by the host and plugin authors; it only
+ *  guards against ingesting a table of functions of another type.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Identifies a cppregpattern_table
+#define CPPREGPATTERN_C_MAGIC 0x43525054u /* "CRPT" */
+
+/// Version of the table layout; tables of another version are rejected
+#define CPPREGPATTERN_C_ABI_VERSION 1u
+
+/// Generic function pointer type; records hold their function cast to it
+typedef void (*cppregpattern_fn)(void);
+
+/// One registered function
+typedef struct cppregpattern_entry {
+  const char* key;  ///< Key bytes, not necessarily null-terminated
+  size_t key_len;   ///< Number of key bytes
+  cppregpattern_fn fn;
+} cppregpattern_entry;
+
+/// A plugin's table of functions
+typedef struct cppregpattern_table {
+  uint32_t magic;        ///< CPPREGPATTERN_C_MAGIC
+  uint16_t abi_version;  ///< CPPREGPATTERN_C_ABI_VERSION
+  uint16_t entry_size;   ///< sizeof(cppregpattern_entry) of the plugin
+  const char* signature;  ///< Function type tag agreed with the host
+  size_t count;
+  const cppregpattern_entry* entries;
+} cppregpattern_table;
+
+#ifdef __cplusplus
+}
+#endif
+
+/// A record for a string literal key and a function
+#define CPPREGPATTERN_C_ENTRY(key, fn) \
+  { (key), sizeof(key) - 1, (cppregpattern_fn)(fn) }
+
+#ifdef __cplusplus
+#define CPPREGPATTERN_C_EXPORT extern "C"
+#else
+#define CPPREGPATTERN_C_EXPORT
+#endif
+
+/// Defines the exported table `name` over the array `entries`
+#define CPPREGPATTERN_C_TABLE(name, signature, entries)                      \
+  CPPREGPATTERN_C_EXPORT const cppregpattern_table name;                     \
+  const cppregpattern_table name = {                                         \
+      CPPREGPATTERN_C_MAGIC, CPPREGPATTERN_C_ABI_VERSION,                    \
+      (uint16_t)sizeof(cppregpattern_entry), (signature),                    \
+      sizeof(entries) / sizeof((entries)[0]), (entries)}
+
+#ifdef __cplusplus
+
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "cppregpattern/key_codec.h"
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+namespace detail {
+
+/// The plain function pointer type matching a stored callable type
+template <class F>
+struct FunctionPointer;
+
+template <class R, class... Args>
+struct FunctionPointer<R (*)(Args...)> {
+  using type = R (*)(Args...);
+};
+
+template <template <class...> class Wrapper, class R, class... Args>
+struct FunctionPointer<Wrapper<R(Args...)>> {
+  using type = R (*)(Args...);
+};
+
+inline const cppregpattern_entry& CEntry(const cppregpattern_table& table,
+                                         size_t i) {
+  return *reinterpret_cast<const cppregpattern_entry*>(
+      reinterpret_cast<const char*>(table.entries) + i * table.entry_size);
+}
+
+}
+
+/** Registers all records of a plugin's C table in `registry` with a single
+ *  Commit(), so dispatches see either none or all of them. Keys are built
+ *  with KeyCodec::Decode() from the record's bytes. With a function pointer
+ *  `Func` such as `int (*)(int, int)`, each function pointer is kept in the
+ *  registry's table entry itself, and Dispatch() calls the plugin's
+ *  function through it, without a `std::function` or another load in
+ *  between.
+ *
+ *  \param registry   A BasicRegistry, e.g. Registry::Instance()
+ *  \param table      The plugin's table
+ *  \param signature  The function type tag the table must carry
+ *
+ *  \throws std::invalid_argument if the table has the wrong magic, ABI
+ *          version or signature, or a record has no function or an
+ *          undecodable key; nothing is registered then
+ *
+ *  \return The new Version() of the registry
+ */
+template <class Registry>
+std::uint64_t IngestCTable(Registry& registry,
+                           const cppregpattern_table& table,
+                           const char* signature) {
+  using key_t = typename Registry::key_type;
+  using pointer_t =
+      typename detail::FunctionPointer<typename Registry::func_t>::type;
+  auto fail = [](const char* what) {
+    throw std::invalid_argument(std::string("registry::IngestCTable: ") +
+                                what);
+  };
+  if (table.magic != CPPREGPATTERN_C_MAGIC) fail("not a dispatch table");
+  if (table.abi_version != CPPREGPATTERN_C_ABI_VERSION) {
+    fail("unsupported ABI version");
+  }
+  // Later versions may append fields to records, never remove them
+  if (table.entry_size < sizeof(cppregpattern_entry)) fail("short records");
+  if (table.signature == nullptr ||
+      std::strcmp(table.signature, signature) != 0) {
+    fail("signature mismatch");
+  }
+
+  typename Registry::Transaction txn;
+  for (size_t i = 0; i < table.count; ++i) {
+    const cppregpattern_entry& entry = detail::CEntry(table, i);
+    key_t key{};
+    if (entry.fn == nullptr ||
+        (entry.key == nullptr && entry.key_len != 0) ||
+        !KeyCodec<key_t>::Decode(entry.key, entry.key_len, &key)) {
+      fail("invalid record");
+    }
+    txn.Register(key, reinterpret_cast<pointer_t>(entry.fn));
+  }
+  return registry.Commit(std::move(txn));
+}
+
+}
+
+#endif
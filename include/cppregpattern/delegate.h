@@ -0,0 +1,135 @@
+/** Interface file for the Delegate class template
+ *
+ *  \file delegate.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace registry {
+
+template <class Sig>
+class Delegate;
+
+/** A callable made of an object pointer and a plain function pointer (the
+ *  "stub") that invokes a member function known at compile time on it: two
+ *  words, trivially copyable, never allocating. Used as the `Func` parameter
+ *  of BasicRegistry or Registry, Dispatch() reaches the member function with
+ *  a single indirect call through the stub.
+ *
+ *  \code{.cpp}
+ *  using Handlers = Registry<std::string, Delegate<Reply(const Request&)>>;
+ *  Handlers::Register<&Server::Echo>("echo", server);
+ *  Handlers::Register("ping", Delegate<Reply(const Request&)>(&Ping));
+ *  \endcode
+ *
+ *  The bound object is not owned and must outlive the registration.
+ */
+template <class R, class... Args>
+class Delegate<R(Args...)> {
+ public:
+  using result_type = R;
+
+  constexpr Delegate() noexcept = default;
+
+  /// Wraps a free function called through a pointer stored in the delegate
+  Delegate(R (*func)(Args...)) noexcept  // NOLINT: like std::function
+      : stub_(func != nullptr ? &FunctionPointerStub : nullptr) {
+    target_.func = func;
+  }
+
+  /// Binds the member function `Method` to `obj`
+  template <auto Method, class C>
+  static Delegate Bind(C& obj) noexcept {
+    Delegate d;
+    d.target_.obj = const_cast<void*>(static_cast<const void*>(&obj));
+    d.stub_ = &MethodStub<C, Method>;
+    return d;
+  }
+
+  /// Binds the free function `Function` without storing a pointer to it
+  template <auto Function>
+  static Delegate Bind() noexcept {
+    Delegate d;
+    d.stub_ = &FunctionStub<Function>;
+    return d;
+  }
+
+  R operator()(Args... args) const {
+    return stub_(target_, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const noexcept { return stub_ != nullptr; }
+
+ private:
+  union Target {
+    void* obj;
+    R (*func)(Args...);
+  };
+  using stub_t = R (*)(Target, Args...);
+
+  template <class C, auto Method>
+  static R MethodStub(Target target, Args... args) {
+    return (static_cast<C*>(target.obj)->*Method)(std::forward<Args>(args)...);
+  }
+
+  template <auto Function>
+  static R FunctionStub(Target, Args... args) {
+    return Function(std::forward<Args>(args)...);
+  }
+
+  static R FunctionPointerStub(Target target, Args... args) {
+    return target.func(std::forward<Args>(args)...);
+  }
+
+  Target target_ = {nullptr};
+  stub_t stub_ = nullptr;
+};
+
+namespace detail {
+
+/// The function signature of a member function pointer type, for the
+/// cv-, lvalue-ref- and noexcept-qualified forms a Delegate can call
+template <class Method>
+struct MethodSignature;
+
+#define CPPREGPATTERN_METHOD_SIGNATURE(qualifiers)                  \
+  template <class R, class C, class... Args>                        \
+  struct MethodSignature<R (C::*)(Args...) qualifiers> {            \
+    using type = R(Args...);                                        \
+  };                                                                \
+  template <class R, class C, class... Args>                        \
+  struct MethodSignature<R (C::*)(Args...) qualifiers noexcept> {   \
+    using type = R(Args...);                                        \
+  };
+
+CPPREGPATTERN_METHOD_SIGNATURE()
+CPPREGPATTERN_METHOD_SIGNATURE(const)
+CPPREGPATTERN_METHOD_SIGNATURE(&)
+CPPREGPATTERN_METHOD_SIGNATURE(const&)
+#undef CPPREGPATTERN_METHOD_SIGNATURE
+
+template <class Func>
+struct IsDelegate : std::false_type {};
+
+template <class Sig>
+struct IsDelegate<Delegate<Sig>> : std::true_type {};
+
+/// Binds `Method` to `obj` as a `FuncT`: the delegate itself if FuncT is a
+/// Delegate, otherwise a FuncT wrapping a delegate of the method's signature
+template <auto Method, class FuncT, class C>
+FuncT BindMethod(C& obj) {
+  if constexpr (IsDelegate<FuncT>::value) {
+    return FuncT::template Bind<Method>(obj);
+  } else {
+    using sig_t = typename MethodSignature<decltype(Method)>::type;
+    return FuncT(Delegate<sig_t>::template Bind<Method>(obj));
+  }
+}
+
+}
+
+}
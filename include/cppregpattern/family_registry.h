@@ -0,0 +1,420 @@
+/** Interface file for the KeyFamilyRegistry class template
+ *
+ *  \file family_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/** Parameters parsed from a concrete key that matched a key family pattern,
+ *  in the order their placeholders appear in the pattern. String parameters
+ *  and key() view the dispatched key and are only valid for the duration of
+ *  the factory call; copy them into the bound function if needed.
+ */
+class KeyParams {
+ public:
+  /// The concrete key that matched
+  std::string_view key() const { return key_; }
+
+  /// Number of parsed parameters
+  std::size_t size() const { return params_.size(); }
+
+  /// Whether parameter `i` came from an `{int}` placeholder
+  bool IsInt(std::size_t i) const { return params_.at(i).is_int; }
+
+  /// Value of the `{int}` parameter `i`
+  std::int64_t Int(std::size_t i) const { return params_.at(i).value; }
+
+  /// Text of parameter `i` (the digits, for an `{int}` parameter)
+  std::string_view Str(std::size_t i) const { return params_.at(i).text; }
+
+ private:
+  template <class F, MissingKeyPolicy M>
+  friend class KeyFamilyRegistry;
+
+  struct Param {
+    bool is_int;
+    std::int64_t value;
+    std::string_view text;
+  };
+
+  std::string_view key_;
+  std::vector<Param> params_;
+};
+
+/** A self-registering map of functions keyed by strings, where besides
+ *  concrete keys a whole family of keys can be registered with one pattern
+ *  such as `resize_{int}` or `blur_{int}x{int}`. Instead of a function, a
+ *  family registers a factory that receives the parsed KeyParams and returns
+ *  the function to call for that concrete key.
+ *
+ *  \par
+ *  Supported placeholders are `{int}`, a run of decimal digits with an
+ *  optional leading `-`, and `{str}`, a non-empty run of characters up to the
+ *  next literal text of the pattern. Dispatch() first looks up the concrete
+ *  keys. Failing that, families are indexed by the literal prefix before
+ *  their first placeholder and tried longest prefix first (most recently
+ *  registered first among equal prefixes). The parameters are parsed once,
+ *  and the function returned by the factory is cached under the concrete key
+ *  once that key has been dispatched SetCacheThreshold() times, so frequently
+ *  used keys skip matching and binding on later calls. The cache holds up to
+ *  4096 keys and is emptied when full, so keys built from request data do
+ *  not grow it without bound.
+ *
+ *  \par
+ *  Register() and RegisterFamily() must not be called concurrently with
+ *  Dispatch(). Concurrent Dispatch() calls are fine; the cache of bound keys
+ *  is protected by its own lock, which is only taken for keys that are not
+ *  registered concretely.
+ *
+ *  \code{.cpp}
+ *  using OpRegistry = KeyFamilyRegistry<std::unique_ptr<Op>()>;
+ *  OpRegistry::RegisterFamily("resize_{int}", [](const KeyParams& p) {
+ *    int size = static_cast<int>(p.Int(0));
+ *    return [size] { return std::unique_ptr<Op>(new Resize(size)); };
+ *  });
+ *  auto op = OpRegistry::Dispatch("resize_512");
+ *  \endcode
+ *
+ *  \tparam Func  The function signature type for the function map
+ *  \tparam MKP   The behavior policy for what to do in the case of a key
+ *                that is neither registered nor matched by a family
+ */
+template <class Func, MissingKeyPolicy MKP = MissingKeyPolicy::exception>
+class KeyFamilyRegistry {
+ public:
+  /// Function object stored for each key
+  using func_t = std::function<Func>;
+
+  /// Factory registered for a key family
+  using factory_t = std::function<func_t(const KeyParams&)>;
+
+  using missing_key_t =
+      detail::MissingKey<MKP, typename func_t::result_type>;
+
+  KeyFamilyRegistry() = delete;
+  KeyFamilyRegistry(const KeyFamilyRegistry&) = delete;
+  KeyFamilyRegistry(KeyFamilyRegistry&&) noexcept = delete;
+  KeyFamilyRegistry& operator=(const KeyFamilyRegistry&) = delete;
+  KeyFamilyRegistry& operator=(KeyFamilyRegistry&&) noexcept = delete;
+
+  /** Calls the function registered for `key`, or bound for it by the
+   *  factory of the key family matching it
+   *
+   *  \param key   A concrete key
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  static typename missing_key_t::ret_t Dispatch(std::string_view key,
+                                                Args&&... args) {
+    CPPREGPATTERN_RT_SCOPE("registry::KeyFamilyRegistry::Dispatch");
+    State& s = state();
+    auto it = s.concrete.find(key);
+    if (it != s.concrete.end()) {
+      return it->second->func(std::forward<Args>(args)...);
+    }
+    if (std::shared_ptr<const Entry> cached = FindCached(s, key)) {
+      return cached->func(std::forward<Args>(args)...);
+    }
+
+    func_t bound = Bind(s, key);
+    if (!bound) {
+      return missing_key_t::Handle(
+          "registry::KeyFamilyRegistry::Dispatch: unknown key");
+    }
+    return bound(std::forward<Args>(args)...);
+  }
+
+  /** Register a function for a concrete key
+   *
+   *  \param key   The identifier under which to register this function
+   *  \param func  Function to register
+   *
+   *  \return Whether registration is successful
+   */
+  static bool Register(const std::string& key, const func_t& func) {
+    State& s = state();
+    auto it = s.concrete.find(key);
+    if (it != s.concrete.end()) {
+      it->second->func = func;
+    } else {
+      std::unique_ptr<Entry> entry(new Entry{key, func});
+      std::string_view view = entry->key;
+      s.concrete.emplace(view, std::move(entry));
+    }
+    ClearCache(s);
+    return true;
+  }
+
+  /** Register a factory for a family of keys
+   *
+   *  \param pattern  Key pattern made of literal text and `{int}` / `{str}`
+   *                  placeholders. There must be at least one placeholder,
+   *                  and placeholders must be separated by literal text.
+   *  \param factory  Called with the parsed parameters of a matching key;
+   *                  returns the function to call for that key
+   *
+   *  \return Whether registration is successful (false for invalid patterns)
+   */
+  static bool RegisterFamily(const std::string& pattern,
+                             const factory_t& factory) {
+    std::unique_ptr<Family> family(new Family);
+    family->pattern = pattern;
+    family->factory = factory;
+    if (!Parse(*family)) return false;
+
+    State& s = state();
+    UnregisterFamily(pattern);
+    auto bucket = s.by_prefix.find(family->prefix);
+    if (bucket == s.by_prefix.end()) {
+      std::unique_ptr<std::string> prefix(new std::string(family->prefix));
+      std::string_view view = *prefix;
+      bucket = s.by_prefix.emplace(view, Bucket{std::move(prefix), {}}).first;
+    }
+    auto& families = bucket->second.families;
+    families.insert(families.begin(), family.get());
+    if (std::find(s.prefix_lengths.begin(), s.prefix_lengths.end(),
+                  family->prefix.size()) == s.prefix_lengths.end()) {
+      s.prefix_lengths.push_back(family->prefix.size());
+      std::sort(s.prefix_lengths.begin(), s.prefix_lengths.end(),
+                std::greater<std::size_t>());
+    }
+    s.families.push_back(std::move(family));
+    ClearCache(s);
+    return true;
+  }
+
+  /// Test whether the key is registered or matched by a key family
+  static bool IsRegistered(std::string_view key) {
+    State& s = state();
+    if (s.concrete.count(key) == 1u) return true;
+    KeyParams params;
+    return Match(s, key, params) != nullptr;
+  }
+
+  /// Unregisters the given concrete key
+  static void Unregister(std::string_view key) {
+    State& s = state();
+    s.concrete.erase(key);
+    ClearCache(s);
+  }
+
+  /// Unregisters the key family with the given pattern
+  static void UnregisterFamily(const std::string& pattern) {
+    State& s = state();
+    for (auto it = s.families.begin(); it != s.families.end(); ++it) {
+      Family* family = it->get();
+      if (family->pattern != pattern) continue;
+      auto bucket = s.by_prefix.find(family->prefix);
+      auto& families = bucket->second.families;
+      families.erase(std::find(families.begin(), families.end(), family));
+      if (families.empty()) s.by_prefix.erase(bucket);
+      s.families.erase(it);
+      break;
+    }
+    ClearCache(s);
+  }
+
+  /** Sets how many times a concrete key has to be dispatched through its
+   *  family before the bound function is cached. 1 (the default) caches on
+   *  first use, 0 never caches. Clears the cache.
+   */
+  static void SetCacheThreshold(std::size_t dispatches) {
+    State& s = state();
+    std::unique_lock<std::shared_mutex> lock(s.cache_mutex);
+    s.cache_threshold = dispatches;
+    s.cache.clear();
+    s.hits.clear();
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    func_t func;
+  };
+
+  struct Segment {
+    bool is_placeholder;
+    bool is_int;          // For placeholders
+    std::string literal;  // For literal text
+  };
+
+  struct Family {
+    std::string pattern;
+    std::string prefix;
+    std::vector<Segment> segments;  // Everything after the prefix
+    factory_t factory;
+  };
+
+  struct Bucket {
+    std::unique_ptr<std::string> prefix;  // Backs the by_prefix key
+    std::vector<Family*> families;        // Most recently registered first
+  };
+
+  // Bounds the memory used for counting dispatches of not-yet-cached keys.
+  static constexpr std::size_t kMaxTrackedKeys = 4096;
+
+  // Bounds the number of bound functions cached.
+  static constexpr std::size_t kMaxCachedKeys = 4096;
+
+  struct State {
+    std::unordered_map<std::string_view, std::unique_ptr<Entry>> concrete;
+
+    std::vector<std::unique_ptr<Family>> families;
+    std::unordered_map<std::string_view, Bucket> by_prefix;
+    std::vector<std::size_t> prefix_lengths;  // Descending
+
+    std::shared_mutex cache_mutex;
+    std::size_t cache_threshold = 1;
+    // Dispatches in flight keep the entry they are calling alive
+    std::unordered_map<std::string_view, std::shared_ptr<const Entry>> cache;
+    std::unordered_map<std::string, std::size_t> hits;
+  };
+
+  static State& state() {
+    static State s;
+    return s;
+  }
+
+  static void ClearCache(State& s) {
+    std::unique_lock<std::shared_mutex> lock(s.cache_mutex);
+    s.cache.clear();
+    s.hits.clear();
+  }
+
+  /// Splits a pattern into its literal prefix and segments
+  static bool Parse(Family& family) {
+    static constexpr std::string_view kInt = "{int}";
+    static constexpr std::string_view kStr = "{str}";
+
+    std::string_view rest = family.pattern;
+    bool in_prefix = true;
+    while (!rest.empty()) {
+      std::size_t brace = rest.find('{');
+      std::string_view literal = rest.substr(0, brace);
+      if (!literal.empty()) {
+        if (in_prefix) {
+          family.prefix = std::string(literal);
+        } else {
+          family.segments.push_back(
+              Segment{false, false, std::string(literal)});
+        }
+      }
+      if (brace == std::string_view::npos) break;
+
+      rest = rest.substr(brace);
+      bool is_int = rest.substr(0, kInt.size()) == kInt;
+      if (!is_int && rest.substr(0, kStr.size()) != kStr) return false;
+      // Placeholders have to be delimited by literal text.
+      if (!family.segments.empty() && family.segments.back().is_placeholder) {
+        return false;
+      }
+      family.segments.push_back(Segment{true, is_int, std::string()});
+      rest = rest.substr(kInt.size());
+      in_prefix = false;
+    }
+    return !in_prefix;
+  }
+
+  /// Matches the part of `key` after the family's prefix
+  static bool MatchSegments(const Family& family, std::string_view rest,
+                            KeyParams& params) {
+    params.params_.clear();
+    const auto& segments = family.segments;
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+      const Segment& seg = segments[i];
+      if (!seg.is_placeholder) {
+        if (rest.substr(0, seg.literal.size()) != seg.literal) return false;
+        rest.remove_prefix(seg.literal.size());
+      } else if (seg.is_int) {
+        std::int64_t value = 0;
+        auto res = std::from_chars(rest.data(), rest.data() + rest.size(),
+                                   value);
+        if (res.ec != std::errc()) return false;
+        auto len = static_cast<std::size_t>(res.ptr - rest.data());
+        params.params_.push_back({true, value, rest.substr(0, len)});
+        rest.remove_prefix(len);
+      } else {
+        std::size_t len = rest.size();
+        if (i + 1 < segments.size()) {
+          len = rest.find(segments[i + 1].literal);
+          if (len == std::string_view::npos) return false;
+        }
+        if (len == 0) return false;
+        params.params_.push_back({false, 0, rest.substr(0, len)});
+        rest.remove_prefix(len);
+      }
+    }
+    return rest.empty();
+  }
+
+  /// Finds the family matching `key` and parses its parameters
+  static const Family* Match(const State& s, std::string_view key,
+                             KeyParams& params) {
+    params.key_ = key;
+    for (std::size_t len : s.prefix_lengths) {
+      if (len > key.size()) continue;
+      auto bucket = s.by_prefix.find(key.substr(0, len));
+      if (bucket == s.by_prefix.end()) continue;
+      for (const Family* family : bucket->second.families) {
+        if (MatchSegments(*family, key.substr(len), params)) return family;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Looks up a key family binding cached by Bind(). The entry is shared,
+  /// so that it outlives the lock even if the cache is cleared meanwhile.
+  static std::shared_ptr<const Entry> FindCached(State& s,
+                                                 std::string_view key) {
+    detail::CheckedLock<std::shared_lock<std::shared_mutex>> lock(
+        s.cache_mutex);
+    auto it = s.cache.find(key);
+    return it == s.cache.end() ? nullptr : it->second;
+  }
+
+  /// Binds a key that is not registered concretely through its family
+  static func_t Bind(State& s, std::string_view key) {
+    KeyParams params;
+    const Family* family = Match(s, key, params);
+    if (family == nullptr) return func_t();
+    func_t bound = family->factory(params);
+
+    detail::CheckedLock<std::unique_lock<std::shared_mutex>> lock(
+        s.cache_mutex);
+    if (s.cache_threshold == 0 || s.cache.count(key) == 1u) return bound;
+    if (s.cache_threshold > 1) {
+      if (s.hits.size() >= kMaxTrackedKeys) s.hits.clear();
+      std::size_t& hits = s.hits[std::string(key)];
+      if (++hits < s.cache_threshold) return bound;
+      s.hits.erase(std::string(key));
+    }
+    if (s.cache.size() >= kMaxCachedKeys) s.cache.clear();
+    std::shared_ptr<const Entry> entry(new Entry{std::string(key), bound});
+    std::string_view view = entry->key;
+    s.cache.emplace(view, std::move(entry));
+    return bound;
+  }
+};
+
+}
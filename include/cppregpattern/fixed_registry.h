@@ -0,0 +1,332 @@
+/** Interface file for the FixedRegistry class template
+ *
+ *  \file fixed_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "cppregpattern/registry.h"
+
+/// Asserts constant initialization of static storage where supported
+#if defined(__cpp_constinit)
+#define CPPREGPATTERN_CONSTINIT constinit
+#else
+#define CPPREGPATTERN_CONSTINIT
+#endif
+
+namespace registry {
+
+/** A string key of at most N characters stored inline. Constructing one
+ *  from a longer string yields an invalid key, which equals no other key and
+ *  is rejected by FixedRegistry::TryRegister().
+ */
+template <std::size_t N>
+class FixedString {
+ public:
+  constexpr FixedString() = default;
+
+  constexpr FixedString(const char* str) {  // NOLINT: implicit by design
+    std::size_t len = 0;
+    while (str[len] != '\0') {
+      if (len == N) {
+        size_ = kInvalid;
+        return;
+      }
+      data_[len] = str[len];
+      ++len;
+    }
+    size_ = len;
+  }
+
+  constexpr bool valid() const { return size_ != kInvalid; }
+  constexpr std::size_t size() const { return valid() ? size_ : 0; }
+  constexpr const char* data() const { return data_; }
+  static constexpr std::size_t capacity() { return N; }
+
+  friend constexpr bool operator==(const FixedString& a,
+                                   const FixedString& b) {
+    if (!a.valid() || !b.valid() || a.size_ != b.size_) return false;
+    for (std::size_t i = 0; i < a.size_; ++i) {
+      if (a.data_[i] != b.data_[i]) return false;
+    }
+    return true;
+  }
+  friend constexpr bool operator!=(const FixedString& a,
+                                   const FixedString& b) {
+    return !(a == b);
+  }
+
+ private:
+  static constexpr std::size_t kInvalid = static_cast<std::size_t>(-1);
+
+  char data_[N + 1] = {};
+  std::size_t size_ = 0;
+};
+
+template <class Sig, std::size_t Size = 2 * sizeof(void*)>
+class InplaceFunction;
+
+/** A callable wrapper like `std::function` that stores its target in an
+ *  inline buffer of `Size` bytes and never allocates. Targets must be
+ *  trivially copyable and destructible (function pointers and lambdas that
+ *  capture pointers or scalars by value), which keeps the wrapper itself
+ *  trivially copyable and usable in constant-initialized storage. Other
+ *  targets are rejected at compile time.
+ */
+template <class R, class... Args, std::size_t Size>
+class InplaceFunction<R(Args...), Size> {
+ public:
+  constexpr InplaceFunction() = default;
+
+  template <class F, class T = typename std::decay<F>::type,
+            class = typename std::enable_if<
+                !std::is_same<T, InplaceFunction>::value>::type>
+  InplaceFunction(F&& func) {  // NOLINT: implicit like std::function
+    static_assert(sizeof(T) <= Size,
+                  "callable does not fit the InplaceFunction buffer");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "callable is over-aligned for InplaceFunction");
+    static_assert(std::is_trivially_copyable<T>::value &&
+                      std::is_trivially_destructible<T>::value,
+                  "InplaceFunction needs a trivially copyable callable");
+    ::new (static_cast<void*>(storage_)) T(std::forward<F>(func));
+    invoke_ = &Invoke<T>;
+  }
+
+  explicit operator bool() const { return invoke_ != nullptr; }
+
+  R operator()(Args... args) const {
+    return invoke_(storage_, std::forward<Args>(args)...);
+  }
+
+ private:
+  template <class T>
+  static R Invoke(void* target, Args&&... args) {
+    return (*static_cast<T*>(target))(std::forward<Args>(args)...);
+  }
+
+  alignas(std::max_align_t) mutable unsigned char storage_[Size] = {};
+  R (*invoke_)(void*, Args&&...) = nullptr;
+};
+
+/// Outcome of FixedRegistry::TryRegister()
+enum class FixedRegisterStatus {
+  ok,            ///< Registered, possibly replacing an earlier function
+  full,          ///< All Capacity slots are in use
+  probe_limit,   ///< No free slot within MaxProbe slots of the key's home
+  key_too_long,  ///< The key is an invalid FixedString
+};
+
+/// Human-readable description of a FixedRegisterStatus
+constexpr const char* ToString(FixedRegisterStatus status) {
+  return status == FixedRegisterStatus::ok ? "ok"
+         : status == FixedRegisterStatus::full
+             ? "registry capacity exhausted"
+         : status == FixedRegisterStatus::probe_limit
+             ? "probe limit reached, increase Capacity or MaxProbe"
+             : "key exceeds the FixedString length";
+}
+
+namespace detail {
+
+template <class Key>
+constexpr bool IsValidKey(const Key&) {
+  return true;
+}
+template <std::size_t N>
+constexpr bool IsValidKey(const FixedString<N>& key) {
+  return key.valid();
+}
+
+}
+
+/** A self-registering map of functions with a capacity fixed at compile time
+ *  that never allocates, for real-time and embedded code.
+ *
+ *  \par
+ *  The table is an open-addressing array of Capacity slots in constant-
+ *  initialized static storage (`constinit` where available), so it is ready
+ *  before any dynamic initialization and registering from static
+ *  initializers is safe. Keys are stored inline (use FixedString for string
+ *  keys) and callables are function pointers by default, or a literal
+ *  wrapper type such as InplaceFunction. Every key lives within MaxProbe
+ *  slots of its home slot, so Dispatch() inspects at most MaxProbe slots.
+ *  Use the `default_construct` or `optional` MissingKeyPolicy to keep
+ *  missing keys off the exception path. The same threading rules as Registry
+ *  apply.
+ *
+ *  \code{.cpp}
+ *  using Loops = FixedRegistry<FixedString<16>, void(double), 32>;
+ *  static const bool registered = Loops::Register("pid", &PidStep);
+ *  Loops::Dispatch("pid", dt);
+ *  \endcode
+ *
+ *  \tparam Key        The identifier type, stored inline
+ *  \tparam Func       The function signature of the registered functions
+ *  \tparam Capacity   The maximum number of registered keys
+ *  \tparam MKP        The behavior policy for what to do in the case of a
+ *                     missing key
+ *  \tparam Callable   The stored callable type, `Func*` or e.g.
+ *                     InplaceFunction<Func, 32>
+ *  \tparam MaxProbe   The longest probe sequence of any lookup
+ *  \tparam Hash       The hash function for keys, which must not allocate
+ *  \tparam KeyEqual   The key equality function
+ */
+template <class Key, class Func, std::size_t Capacity,
+          MissingKeyPolicy MKP = MissingKeyPolicy::exception,
+          class Callable = Func*, std::size_t MaxProbe = Capacity,
+          class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class FixedRegistry {
+  static_assert(Capacity > 0, "FixedRegistry needs a non-zero capacity");
+  static_assert(MaxProbe > 0 && MaxProbe <= Capacity,
+                "MaxProbe must be in [1, Capacity]");
+
+ public:
+  using func_t = Callable;
+  using missing_key_t =
+      detail::MissingKey<MKP, typename std::function<Func>::result_type>;
+  using ret_t = typename missing_key_t::ret_t;
+
+  static constexpr std::size_t kCapacity = Capacity;
+  static constexpr std::size_t kMaxProbe = MaxProbe;
+
+  FixedRegistry() = delete;
+  FixedRegistry(const FixedRegistry&) = delete;
+  FixedRegistry(FixedRegistry&&) noexcept = delete;
+  FixedRegistry& operator=(const FixedRegistry&) = delete;
+  FixedRegistry& operator=(FixedRegistry&&) noexcept = delete;
+
+  /** Calls one of the registered functions
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  static ret_t Dispatch(const Key& key, Args&&... args) {
+    CPPREGPATTERN_RT_SCOPE("registry::FixedRegistry::Dispatch");
+    const Slot* slot = Find(key);
+    if (slot == nullptr) {
+      return missing_key_t::Handle(
+          "registry::FixedRegistry::Dispatch: unknown key");
+    }
+    return slot->func(std::forward<Args>(args)...);
+  }
+
+  /** Register a function with the registry
+   *
+   *  \param key   The identifier under which to register this function
+   *  \param func  Function to register, replacing any earlier one
+   *
+   *  \return Why registration failed, or FixedRegisterStatus::ok
+   */
+  static FixedRegisterStatus TryRegister(const Key& key, const func_t& func) {
+    if (!detail::IsValidKey(key)) return FixedRegisterStatus::key_too_long;
+    std::size_t home = Home(key);
+    for (std::size_t d = 0; d < MaxProbe; ++d) {
+      Slot& slot = storage_.slots[(home + d) % Capacity];
+      if (slot.used && KeyEqual()(slot.key, key)) {
+        slot.func = func;
+        return FixedRegisterStatus::ok;
+      }
+      if (!slot.used) {
+        slot.key = key;
+        slot.func = func;
+        slot.used = true;
+        ++storage_.count;
+        return FixedRegisterStatus::ok;
+      }
+    }
+    return storage_.count == Capacity ? FixedRegisterStatus::full
+                                      : FixedRegisterStatus::probe_limit;
+  }
+
+  /// Like TryRegister(), returning whether registration is successful
+  static bool Register(const Key& key, const func_t& func) {
+    return TryRegister(key, func) == FixedRegisterStatus::ok;
+  }
+
+  /// Test whether the given identifier is registered
+  static bool IsRegistered(const Key& key) { return Find(key) != nullptr; }
+
+  /// Unregisters the given identifier
+  static void Unregister(const Key& key) {
+    Slot* slot = const_cast<Slot*>(Find(key));
+    if (slot == nullptr) return;
+    // Backward-shift deletion: move later entries of the probe run into the
+    // hole when that brings them closer to home, so no tombstones are needed
+    // and probe lengths never grow.
+    std::size_t hole = static_cast<std::size_t>(slot - storage_.slots);
+    std::size_t i = (hole + 1) % Capacity;
+    for (std::size_t n = 1; n < Capacity && storage_.slots[i].used;
+         ++n, i = (i + 1) % Capacity) {
+      std::size_t home = Home(storage_.slots[i].key);
+      if ((i + Capacity - home) % Capacity >=
+          (hole + Capacity - home) % Capacity) {
+        storage_.slots[hole] = storage_.slots[i];
+        hole = i;
+      }
+    }
+    storage_.slots[hole] = Slot();
+    --storage_.count;
+  }
+
+  /// Number of registered keys
+  static std::size_t size() { return storage_.count; }
+
+ private:
+  struct Slot {
+    Key key{};
+    func_t func{};
+    bool used = false;
+  };
+
+  struct Storage {
+    Slot slots[Capacity];
+    std::size_t count = 0;
+  };
+
+  static std::size_t Home(const Key& key) {
+    std::uint64_t h = static_cast<std::uint64_t>(Hash()(key));
+    return static_cast<std::size_t>((h * 0x9e3779b97f4a7c15ULL) >> 32) %
+           Capacity;
+  }
+
+  static const Slot* Find(const Key& key) {
+    std::size_t home = Home(key);
+    for (std::size_t d = 0; d < MaxProbe; ++d) {
+      const Slot& slot = storage_.slots[(home + d) % Capacity];
+      if (!slot.used) return nullptr;
+      if (KeyEqual()(slot.key, key)) return &slot;
+    }
+    return nullptr;
+  }
+
+  CPPREGPATTERN_CONSTINIT static inline Storage storage_{};
+};
+
+}
+
+namespace std {
+
+template <std::size_t N>
+struct hash<registry::FixedString<N>> {
+  std::size_t operator()(const registry::FixedString<N>& key) const {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < key.size(); ++i) {
+      h = (h ^ static_cast<unsigned char>(key.data()[i])) * 0x100000001b3ULL;
+    }
+    return static_cast<std::size_t>(h);
+  }
+};
+
+}
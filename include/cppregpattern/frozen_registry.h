@@ -0,0 +1,265 @@
+/** Interface file for the FrozenRegistry class template
+ *
+ *  \file frozen_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CPPREGPATTERN_HAS_MMAN 1
+#endif
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/** An immutable copy of a registry laid out in dedicated, page-aligned
+ *  memory regions. It is meant for prefork servers: the parent freezes its
+ *  registries before forking, and since nothing writes to the regions
+ *  (there are no reference counts, caches or allocator metadata in them),
+ *  every worker keeps sharing the parent's copy-on-write pages for its whole
+ *  lifetime.
+ *
+ *  \par
+ *  The lookup region holds an open-addressing slot table of hashes and entry
+ *  indices, followed by a dense array of the keys copied from the source
+ *  registry, which must be sealed; it is made read-only once built. The
+ *  functions are copied to a second region that stays writable, because a
+ *  stateful callable such as `[n = 0]() mutable { return ++n; }` updates
+ *  its state when called: such a call dirties the page of that function in
+ *  the calling process only, and stateless functions are only read. Memory
+ *  owned by the keys and functions themselves lives elsewhere, e.g. the
+ *  characters of long `std::string` keys or large lambda captures.
+ *  Where `mmap` is unavailable the regions are ordinary heap memory and are
+ *  not protected.
+ *
+ *  \code{.cpp}
+ *  Handlers::Seal();
+ *  static const FrozenRegistry<Handlers::instance_t> frozen(
+ *      Handlers::Instance());
+ *  ForkWorkers();  // Workers dispatch through `frozen`
+ *  \endcode
+ *
+ *  \tparam Base  The BasicRegistry type being frozen
+ */
+template <class Base>
+class FrozenRegistry {
+ public:
+  using key_type = typename Base::key_type;
+  using func_t = typename Base::func_t;
+  using missing_key_t = typename Base::missing_key_t;
+  using ret_t = typename Base::ret_t;
+
+  /** Copies the contents of `base` into a new read-only region
+   *
+   *  \throws std::invalid_argument if `base` is not sealed
+   *  \throws std::bad_alloc if a region cannot be mapped
+   *  \throws std::system_error if the lookup region cannot be made
+   *          read-only
+   */
+  explicit FrozenRegistry(const Base& base) {
+    if (!base.IsSealed()) {
+      throw std::invalid_argument(
+          "registry::FrozenRegistry: the source registry must be sealed");
+    }
+    count_ = base.size();
+    capacity_ = 8;
+    shift_ = 61;
+    while (capacity_ < 2 * count_) {
+      capacity_ *= 2;
+      --shift_;
+    }
+    keys_offset_ = AlignUp(capacity_ * sizeof(Slot), alignof(key_type));
+    size_ = AlignUp(keys_offset_ + count_ * sizeof(key_type), PageSize());
+    funcs_size_ = AlignUp(count_ * sizeof(func_t), PageSize());
+    region_ = Map(size_);
+    try {
+      funcs_region_ = Map(funcs_size_);
+    } catch (...) {
+      Release();
+      throw;
+    }
+
+    Slot* slots = reinterpret_cast<Slot*>(region_);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      ::new (static_cast<void*>(slots + i)) Slot{0, kEmpty};
+    }
+    try {
+      base.ForEach([this, slots](const key_type& key, const func_t* func) {
+        std::uint32_t idx = static_cast<std::uint32_t>(built_);
+        ::new (static_cast<void*>(keys() + idx)) key_type(key);
+        try {
+          ::new (static_cast<void*>(funcs() + idx)) func_t(*func);
+        } catch (...) {
+          keys()[idx].~key_type();
+          throw;
+        }
+        ++built_;
+        std::size_t hash = typename Base::hasher()(key);
+        std::size_t i = Home(hash);
+        while (slots[i].index != kEmpty) i = (i + 1) & (capacity_ - 1);
+        slots[i] = Slot{hash, idx};
+      });
+    } catch (...) {
+      Release();
+      throw;
+    }
+#ifdef CPPREGPATTERN_HAS_MMAN
+    if (mprotect(region_, size_, PROT_READ) != 0) {
+      int error = errno;
+      Release();
+      throw std::system_error(
+          error, std::generic_category(),
+          "registry::FrozenRegistry: cannot make the region read-only");
+    }
+    protected_ = true;
+#endif
+  }
+
+  FrozenRegistry(const FrozenRegistry&) = delete;
+  FrozenRegistry& operator=(const FrozenRegistry&) = delete;
+
+  ~FrozenRegistry() { Release(); }
+
+  /** Calls one of the registered functions
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const key_type& key, Args&&... args) const {
+    CPPREGPATTERN_RT_SCOPE("registry::FrozenRegistry::Dispatch");
+    const func_t* func = Find(key);
+    if (func == nullptr) {
+      return missing_key_t::Handle(
+          "registry::FrozenRegistry::Dispatch: unknown key");
+    }
+    return (*func)(std::forward<Args>(args)...);
+  }
+
+  /// Returns the function registered under `key`, or nullptr
+  const func_t* Find(const key_type& key) const {
+    const Slot* slots = reinterpret_cast<const Slot*>(region_);
+    std::size_t hash = typename Base::hasher()(key);
+    for (std::size_t i = Home(hash);; i = (i + 1) & (capacity_ - 1)) {
+      const Slot& slot = slots[i];
+      if (slot.index == kEmpty) return nullptr;
+      if (slot.hash == hash &&
+          typename Base::key_equal()(keys()[slot.index], key)) {
+        return funcs() + slot.index;
+      }
+    }
+  }
+
+  /// Test whether the given identifier is registered
+  bool IsRegistered(const key_type& key) const {
+    return Find(key) != nullptr;
+  }
+
+  /// Number of registered keys
+  std::size_t size() const { return count_; }
+
+  /// Size in bytes of the read-only lookup region
+  std::size_t region_size() const { return size_; }
+
+  /// Size in bytes of the region holding the functions
+  std::size_t funcs_region_size() const { return funcs_size_; }
+
+ private:
+  struct Slot {
+    std::size_t hash;
+    std::uint32_t index;
+  };
+
+  static constexpr std::uint32_t kEmpty = 0xffffffffu;
+
+  static std::size_t AlignUp(std::size_t n, std::size_t align) {
+    return (n + align - 1) / align * align;
+  }
+
+  static std::size_t PageSize() {
+#ifdef CPPREGPATTERN_HAS_MMAN
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<std::size_t>(page) : 4096;
+#else
+    return 4096;
+#endif
+  }
+
+  static unsigned char* Map(std::size_t size) {
+#ifdef CPPREGPATTERN_HAS_MMAN
+    if (size == 0) size = PageSize();
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    return static_cast<unsigned char*>(p);
+#else
+    return static_cast<unsigned char*>(::operator new(size));
+#endif
+  }
+
+  /// Fibonacci hashing, so that identity hashes of small integers spread
+  std::size_t Home(std::size_t hash) const {
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL) >> shift_);
+  }
+
+  key_type* keys() const {
+    return reinterpret_cast<key_type*>(region_ + keys_offset_);
+  }
+  func_t* funcs() const { return reinterpret_cast<func_t*>(funcs_region_); }
+
+  static void Unmap(unsigned char* region, std::size_t size) {
+#ifdef CPPREGPATTERN_HAS_MMAN
+    munmap(region, size == 0 ? PageSize() : size);
+#else
+    (void)size;
+    ::operator delete(region);
+#endif
+  }
+
+  void Release() {
+    if (region_ == nullptr) return;
+#ifdef CPPREGPATTERN_HAS_MMAN
+    // If the region cannot be made writable again, destructors might fault
+    // on it: leak what the keys and functions own rather than crash
+    if (protected_ && mprotect(region_, size_, PROT_READ | PROT_WRITE) != 0) {
+      built_ = 0;
+    }
+#endif
+    for (std::size_t i = 0; i < built_; ++i) {
+      funcs()[i].~func_t();
+      keys()[i].~key_type();
+    }
+    if (funcs_region_ != nullptr) Unmap(funcs_region_, funcs_size_);
+    Unmap(region_, size_);
+    funcs_region_ = nullptr;
+    region_ = nullptr;
+  }
+
+  unsigned char* region_ = nullptr;  // Slots and keys, read-only
+  unsigned char* funcs_region_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t funcs_size_ = 0;
+  std::size_t count_ = 0;
+  std::size_t built_ = 0;
+  std::size_t capacity_ = 0;
+  unsigned shift_ = 0;
+  std::size_t keys_offset_ = 0;
+  bool protected_ = false;
+};
+
+}
@@ -0,0 +1,216 @@
+/** Interface file for the HeteroRegistry class template
+ *
+ *  \file hetero_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/// Identifier of a function signature, unique per signature type
+using signature_id_t = const void*;
+
+namespace detail {
+
+template <class Sig>
+struct SignatureTag {
+  static constexpr char id = 0;
+};
+
+template <class Sig>
+struct Thunk;
+
+/// Typed entry point called by HeteroRegistry with the erased target
+template <class R, class... Args>
+struct Thunk<R(Args...)> {
+  using type = R (*)(void*, Args...);
+
+  template <class F>
+  static R Call(void* target, Args... args) {
+    return (*static_cast<F*>(target))(std::forward<Args>(args)...);
+  }
+};
+
+}
+
+/// Returns the identifier of the function signature `Sig`
+template <class Sig>
+constexpr signature_id_t SignatureId() {
+  return &detail::SignatureTag<Sig>::id;
+}
+
+/** A self-registering map of functions in which every key can hold a
+ *  function of a different signature, so that one registry can serve
+ *  functions that would otherwise need a Registry per signature.
+ *
+ *  \par
+ *  Each entry stores its callable directly (inline when it is at most
+ *  kInlineSize bytes, e.g. function pointers and small lambdas, on the heap
+ *  otherwise), a plain function pointer that invokes it, and the
+ *  SignatureId() of the signature it was registered with. Dispatch<Sig>()
+ *  compares that id with SignatureId<Sig>() and calls through the function
+ *  pointer, without `std::function` or `std::any` in between. Dispatching
+ *  with a signature different from the registered one is handled like a
+ *  missing key. The same threading rules as Registry apply.
+ *
+ *  \code{.cpp}
+ *  using Plugins = HeteroRegistry<std::string>;
+ *  Plugins::Register<int(int)>("inc", [](int x) { return x + 1; });
+ *  Plugins::Register("parse", &ParseConfig);  // Signature deduced
+ *  int two = Plugins::Dispatch<int(int)>("inc", 1);
+ *  \endcode
+ *
+ *  \tparam Key        The identifier type for the function map
+ *  \tparam MKP        The behavior policy for what to do in the case of a
+ *                     missing key or a signature mismatch
+ *  \tparam Hash       The hash function to use for the function map
+ *  \tparam KeyEqual   The key equality function for the function map
+ */
+template <class Key, MissingKeyPolicy MKP = MissingKeyPolicy::exception,
+          class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class HeteroRegistry {
+ public:
+  /// Callables up to this size (and suitably aligned) are stored inline
+  static constexpr std::size_t kInlineSize = 3 * sizeof(void*);
+
+  template <class Sig>
+  using missing_key_t =
+      detail::MissingKey<MKP, typename std::function<Sig>::result_type>;
+
+  HeteroRegistry() = delete;
+  HeteroRegistry(const HeteroRegistry&) = delete;
+  HeteroRegistry(HeteroRegistry&&) noexcept = delete;
+  HeteroRegistry& operator=(const HeteroRegistry&) = delete;
+  HeteroRegistry& operator=(HeteroRegistry&&) noexcept = delete;
+
+  /** Calls one of the registered functions
+   *
+   *  \tparam Sig  The signature the function was registered with
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <class Sig, typename... Args>
+  static typename missing_key_t<Sig>::ret_t Dispatch(const Key& key,
+                                                     Args&&... args) {
+    CPPREGPATTERN_RT_SCOPE("registry::HeteroRegistry::Dispatch");
+    auto it = entries().find(key);
+    if (it == entries().end()) {
+      return missing_key_t<Sig>::Handle(
+          "registry::HeteroRegistry::Dispatch: unknown key");
+    }
+    const Entry& entry = it->second;
+    if (entry.signature != SignatureId<Sig>()) {
+      return missing_key_t<Sig>::Handle(
+          "registry::HeteroRegistry::Dispatch: signature mismatch");
+    }
+    auto thunk = reinterpret_cast<typename detail::Thunk<Sig>::type>(
+        entry.thunk);
+    return thunk(entry.target, std::forward<Args>(args)...);
+  }
+
+  /** Register a function with the registry
+   *
+   *  \tparam Sig  The signature to register the function under
+   *
+   *  \param key   The identifier under which to register this function
+   *  \param func  Callable invocable with the signature `Sig`. Replaces any
+   *               function previously registered under `key`.
+   *
+   *  \return Whether registration is successful
+   */
+  template <class Sig, class F>
+  static bool Register(const Key& key, F&& func) {
+    using target_t = typename std::decay<F>::type;
+    entries().erase(key);
+    entries().emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                      std::forward_as_tuple(
+                          SignatureId<Sig>(),
+                          reinterpret_cast<void (*)()>(
+                              &detail::Thunk<Sig>::template Call<target_t>),
+                          std::forward<F>(func)));
+    return true;
+  }
+
+  /// Register a function pointer, deducing the signature from its type
+  template <class R, class... A>
+  static bool Register(const Key& key, R (*func)(A...)) {
+    return Register<R(A...)>(key, func);
+  }
+
+  /// Test whether the given identifier is registered
+  static bool IsRegistered(const Key& key) {
+    return entries().count(key) == 1u;
+  }
+
+  /// Test whether the given identifier is registered with signature `Sig`
+  template <class Sig>
+  static bool IsRegistered(const Key& key) {
+    auto it = entries().find(key);
+    return it != entries().end() && it->second.signature == SignatureId<Sig>();
+  }
+
+  /// Unregisters the given identifier
+  static void Unregister(const Key& key) { entries().erase(key); }
+
+ private:
+  /// An erased callable. Entries are constructed in place in their map node
+  /// and never move, so inline targets need no relocation support.
+  struct Entry {
+    template <class F>
+    Entry(signature_id_t sig, void (*invoke)(), F&& func)
+        : signature(sig), thunk(invoke) {
+      using target_t = typename std::decay<F>::type;
+      if constexpr (sizeof(target_t) <= kInlineSize &&
+                    alignof(target_t) <= alignof(std::max_align_t)) {
+        target = ::new (static_cast<void*>(storage))
+            target_t(std::forward<F>(func));
+      } else {
+        target = new target_t(std::forward<F>(func));
+      }
+      destroy = &Destroy<target_t>;
+    }
+
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    ~Entry() { destroy(target, target != static_cast<void*>(storage)); }
+
+    template <class T>
+    static void Destroy(void* target, bool on_heap) {
+      if (on_heap) {
+        delete static_cast<T*>(target);
+      } else {
+        static_cast<T*>(target)->~T();
+      }
+    }
+
+    signature_id_t signature;
+    void (*thunk)();
+    void* target;
+    void (*destroy)(void*, bool);
+    alignas(std::max_align_t) unsigned char storage[kInlineSize];
+  };
+
+  using map_t = std::unordered_map<Key, Entry, Hash, KeyEqual>;
+
+  static map_t& entries() {
+    static map_t entry_map;
+    return entry_map;
+  }
+};
+
+}
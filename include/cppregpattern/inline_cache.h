@@ -0,0 +1,217 @@
+/** Interface file for the CachedRegistry class template
+ *
+ *  \file inline_cache.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/// Dispatch() counts of the calling thread, see CachedRegistry
+struct InlineCacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+
+  /// Fraction of dispatches served by the cache, 0 if there were none
+  double hit_rate() const {
+    std::uint64_t total = hits + misses;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+  }
+};
+
+/** A view of a BasicRegistry that puts a small per-thread cache in front of
+ *  Dispatch(), for threads that dispatch the same few keys repeatedly.
+ *
+ *  \par
+ *  Each thread has a direct-mapped table of `Slots` entries, indexed by the
+ *  key's hash, that remembers the function found for a key together with the
+ *  registry's Version() at the time. An entry is used only while Version()
+ *  is unchanged, so any Register(), Alias(), Unregister(), Commit() or
+ *  resolution of a lazy entry invalidates the whole cache. A hit still
+ *  hashes the key and compares it once with the registry's own copy of the
+ *  cached key, to tell colliding keys apart, so the cache never copies or
+ *  allocates keys; it saves the probe of the registry's index and its
+ *  cache misses, which pays off for large registries and cheap keys, but
+ *  little for small tables of long string keys. For call sites that always
+ *  dispatch the same key, CallSite avoids hashing and comparing altogether.
+ *  Version numbers are unique across registries, so views of different
+ *  registries of the same type can share a thread's cache.
+ *
+ *  \code{.cpp}
+ *  CachedRegistry<Handlers> handlers(Handlers::Instance());
+ *  Response r = handlers.Dispatch("echo", request);
+ *  double rate = decltype(handlers)::ThreadStats().hit_rate();
+ *  \endcode
+ *
+ *  \par
+ *  Cached dispatches do not take the registry's lock, so functions follow
+ *  the lifetime rules of BasicRegistry::Find(): do not call Reclaim() while
+ *  threads may still dispatch through a CachedRegistry, whatever the
+ *  concurrency policy.
+ *
+ *  \tparam Base   The BasicRegistry type, which must outlive this object
+ *  \tparam Slots  The number of cache entries per thread, a power of two
+ */
+template <class Base, std::size_t Slots = 16>
+class CachedRegistry {
+  static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0,
+                "CachedRegistry needs a power-of-two number of slots");
+
+ public:
+  using key_type = typename Base::key_type;
+  using func_t = typename Base::func_t;
+  using missing_key_t = typename Base::missing_key_t;
+  using ret_t = typename Base::ret_t;
+
+  explicit CachedRegistry(const Base& base) : base_(base) {}
+
+  /** Calls one of the registered functions
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const key_type& key, Args&&... args) const {
+    CPPREGPATTERN_RT_SCOPE("registry::CachedRegistry::Dispatch");
+    const func_t* func = Find(key);
+    if (func == nullptr) {
+      return missing_key_t::Handle(
+          "registry::CachedRegistry::Dispatch: unknown key");
+    }
+    return (*func)(std::forward<Args>(args)...);
+  }
+
+  /// Returns the function registered under `key`, or nullptr
+  const func_t* Find(const key_type& key) const {
+    std::size_t hash = typename Base::hasher()(key);
+    Entry& entry = Cache()[Index(hash)];
+    std::uint64_t version = base_.Version();
+    InlineCacheStats& stats = Stats();
+    // The stored key is only valid while the version is unchanged
+    if (entry.version == version && entry.hash == hash &&
+        typename Base::key_equal()(*entry.key, key)) {
+      ++stats.hits;
+      return entry.func;
+    }
+    ++stats.misses;
+    const key_type* stored_key = nullptr;
+    const func_t* func = base_.Find(key, hash, &stored_key);
+    if (func != nullptr) {
+      entry.version = version;
+      entry.hash = hash;
+      entry.key = stored_key;
+      entry.func = func;
+    }
+    return func;
+  }
+
+  /// Test whether the given identifier is registered
+  bool IsRegistered(const key_type& key) const {
+    return base_.IsRegistered(key);
+  }
+
+  /// Hits and misses of the calling thread, over all CachedRegistry views
+  /// of the same type
+  static InlineCacheStats ThreadStats() { return Stats(); }
+
+  /// Resets the calling thread's counters
+  static void ResetThreadStats() { Stats() = InlineCacheStats(); }
+
+  /// The registry behind the cache
+  const Base& base() const { return base_; }
+
+ private:
+  struct Entry {
+    std::uint64_t version = 0;  // 0 is never a registry version
+    std::size_t hash = 0;
+    const key_type* key = nullptr;  // The registry's copy
+    const func_t* func = nullptr;
+  };
+
+  static std::size_t Index(std::size_t hash) {
+    // Fibonacci hashing spreads weak hashes such as std::hash<int>
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL) >> 40) &
+           (Slots - 1);
+  }
+
+  static Entry* Cache() {
+    thread_local Entry cache[Slots];
+    return cache;
+  }
+
+  static InlineCacheStats& Stats() {
+    thread_local InlineCacheStats stats;
+    return stats;
+  }
+
+  const Base& base_;
+};
+
+/** An inline cache for a call site that always dispatches the same key:
+ *  it remembers the function found for the key with the registry's
+ *  Version(), so a dispatch costs one version check and the call, without
+ *  hashing or comparing the key. Use one per thread, e.g. as a
+ *  `thread_local` at the call site; the same lifetime rules as for
+ *  CachedRegistry apply.
+ *
+ *  \code{.cpp}
+ *  thread_local CallSite<Handlers> echo(Handlers::Instance(), "echo");
+ *  Response r = echo.Dispatch(request);
+ *  \endcode
+ *
+ *  \tparam Base  The BasicRegistry type, which must outlive this object
+ */
+template <class Base>
+class CallSite {
+ public:
+  using key_type = typename Base::key_type;
+  using func_t = typename Base::func_t;
+  using missing_key_t = typename Base::missing_key_t;
+  using ret_t = typename Base::ret_t;
+
+  CallSite(const Base& base, key_type key)
+      : base_(base), key_(std::move(key)) {}
+
+  /// Calls the function registered under the site's key
+  template <typename... Args>
+  ret_t Dispatch(Args&&... args) {
+    CPPREGPATTERN_RT_SCOPE("registry::CallSite::Dispatch");
+    std::uint64_t version = base_.Version();
+    if (version == version_) {
+      ++stats_.hits;
+    } else {
+      ++stats_.misses;
+      func_ = base_.Find(key_);
+      version_ = version;
+    }
+    if (func_ == nullptr) {
+      return missing_key_t::Handle("registry::CallSite::Dispatch: unknown key");
+    }
+    return (*func_)(std::forward<Args>(args)...);
+  }
+
+  /// The key dispatched by this site
+  const key_type& key() const { return key_; }
+
+  /// Dispatches served without a lookup, and those that needed one
+  const InlineCacheStats& stats() const { return stats_; }
+
+ private:
+  const Base& base_;
+  const key_type key_;
+  std::uint64_t version_ = 0;  // 0 is never a registry version
+  const func_t* func_ = nullptr;
+  InlineCacheStats stats_;
+};
+
+}
@@ -0,0 +1,312 @@
+/** Interface file for the IntervalRegistry class template
+ *
+ *  \file interval_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/// How IntervalRegistry picks a function when registered intervals overlap
+enum class OverlapPolicy {
+  /// Overlapping registrations are refused; Register() returns false
+  reject = 0,
+  /// The most recently registered covering interval wins
+  last_registered = 1,
+  /// The earliest registered covering interval wins
+  first_registered = 2,
+  /// The covering interval with the greatest lower bound wins, ties going to
+  /// the smallest upper bound and then to the most recent registration
+  most_specific = 3
+};
+
+/** A self-registering map of functions keyed by half-open intervals
+ *  `[lo, hi)` of an ordered key, such as a range of protocol versions.
+ *  Dispatch() calls the function whose interval covers the given value.
+ *
+ *  \par
+ *  Registered intervals are flattened into disjoint segments, each resolved
+ *  to a single function with the OverlapPolicy, and the segment boundaries are
+ *  stored in an Eytzinger (breadth-first) layout, so the binary search in
+ *  Dispatch() walks the array front to back and the top levels of the search
+ *  share a few cache lines. The index is rebuilt once, on the first
+ *  Dispatch() after a registration change. The
+ *  same threading rules as Registry apply: concurrent Dispatch() calls are
+ *  fine, but do not call Register() concurrently with Dispatch().
+ *
+ *  \code{.cpp}
+ *  using DecoderRegistry =
+ *      IntervalRegistry<int, std::unique_ptr<Decoder>()>;
+ *  DecoderRegistry::Register(3, 8, [] { return MakeDecoderA(); });
+ *  DecoderRegistry::RegisterFrom(8, [] { return MakeDecoderB(); });
+ *  auto decoder = DecoderRegistry::Dispatch(5);  // DecoderA
+ *  \endcode
+ *
+ *  \tparam Key      The ordered key type the intervals are defined over
+ *  \tparam Func     The function signature type for the function map
+ *  \tparam MKP      The behavior policy for what to do when no interval
+ *                   covers the dispatched value
+ *  \tparam OP       How to resolve values covered by several intervals
+ *  \tparam Compare  Strict weak ordering over Key
+ */
+template <class Key, class Func,
+          MissingKeyPolicy MKP = MissingKeyPolicy::exception,
+          OverlapPolicy OP = OverlapPolicy::last_registered,
+          class Compare = std::less<Key>>
+class IntervalRegistry {
+ public:
+  /// Function object stored for each interval
+  using func_t = std::function<Func>;
+
+  using missing_key_t =
+      detail::MissingKey<MKP, typename func_t::result_type>;
+
+  IntervalRegistry() = delete;
+  IntervalRegistry(const IntervalRegistry&) = delete;
+  IntervalRegistry(IntervalRegistry&&) noexcept = delete;
+  IntervalRegistry& operator=(const IntervalRegistry&) = delete;
+  IntervalRegistry& operator=(IntervalRegistry&&) noexcept = delete;
+
+  /** Calls the function registered for the interval covering `value`
+   *
+   *  \param value  The value to look up
+   *  \param args   Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  static typename missing_key_t::ret_t Dispatch(const Key& value,
+                                                Args&&... args) {
+    CPPREGPATTERN_RT_SCOPE("registry::IntervalRegistry::Dispatch");
+    const func_t* func = Find(value);
+    if (func == nullptr) {
+      return missing_key_t::Handle(
+          "registry::IntervalRegistry::Dispatch: no interval covers value");
+    }
+    return (*func)(std::forward<Args>(args)...);
+  }
+
+  /** Register a function for the half-open interval `[lo, hi)`
+   *
+   *  \param lo    Inclusive lower bound
+   *  \param hi    Exclusive upper bound
+   *  \param func  Function to register
+   *
+   *  \return Whether registration is successful. Fails for empty intervals
+   *          and, with OverlapPolicy::reject, for overlapping intervals.
+   */
+  static bool Register(const Key& lo, const Key& hi, const func_t& func) {
+    if (!Compare()(lo, hi)) return false;
+    return Add(Interval{lo, hi, false, func, 0});
+  }
+
+  /** Register a function for the unbounded interval `[lo, +inf)`
+   *
+   *  \param lo    Inclusive lower bound
+   *  \param func  Function to register
+   *
+   *  \return Whether registration is successful
+   */
+  static bool RegisterFrom(const Key& lo, const func_t& func) {
+    return Add(Interval{lo, lo, true, func, 0});
+  }
+
+  /// Test whether some registered interval covers `value`
+  static bool IsCovered(const Key& value) { return Find(value) != nullptr; }
+
+  /// Unregisters the interval `[lo, hi)`
+  static void Unregister(const Key& lo, const Key& hi) {
+    Remove([&](const Interval& i) {
+      return !i.open && Equivalent(i.lo, lo) && Equivalent(i.hi, hi);
+    });
+  }
+
+  /// Unregisters the unbounded interval `[lo, +inf)`
+  static void UnregisterFrom(const Key& lo) {
+    Remove([&](const Interval& i) { return i.open && Equivalent(i.lo, lo); });
+  }
+
+ private:
+  struct Interval {
+    Key lo;
+    Key hi;  // Unused when open
+    bool open;
+    func_t func;
+    std::uint64_t seq;
+  };
+
+  static constexpr std::int32_t kNone = -1;
+
+  struct State {
+    std::vector<Interval> intervals;
+    std::uint64_t next_seq = 0;
+
+    // Eytzinger-ordered segment boundaries, 1-based (slot 0 is unused).
+    // before[k] is the interval covering the segment that ends at keys[k].
+    std::vector<Key> keys;
+    std::vector<std::int32_t> before;
+    std::int32_t tail = kNone;  // Interval covering values >= every boundary
+
+    std::atomic<bool> index_valid{false};
+    std::mutex index_mutex;
+  };
+
+  static State& state() {
+    static State s;
+    return s;
+  }
+
+  static bool Equivalent(const Key& a, const Key& b) {
+    return !Compare()(a, b) && !Compare()(b, a);
+  }
+
+  static bool Overlaps(const Interval& a, const Interval& b) {
+    // Each interval must start before the other one ends.
+    return (a.open || Compare()(b.lo, a.hi)) &&
+           (b.open || Compare()(a.lo, b.hi));
+  }
+
+  static bool Add(Interval interval) {
+    State& s = state();
+    if (OP == OverlapPolicy::reject) {
+      for (const Interval& other : s.intervals) {
+        if (Overlaps(interval, other)) return false;
+      }
+    }
+    interval.seq = s.next_seq++;
+    s.intervals.push_back(std::move(interval));
+    s.index_valid.store(false, std::memory_order_release);
+    return true;
+  }
+
+  template <class Pred>
+  static void Remove(Pred pred) {
+    State& s = state();
+    std::vector<Interval> kept;
+    kept.reserve(s.intervals.size());
+    for (Interval& i : s.intervals) {
+      if (!pred(i)) kept.push_back(std::move(i));
+    }
+    s.intervals.swap(kept);
+    s.index_valid.store(false, std::memory_order_release);
+  }
+
+  /// Whether interval `a` takes precedence over interval `b`
+  static bool Preferred(const Interval& a, const Interval& b) {
+    switch (OP) {
+      case OverlapPolicy::first_registered:
+        return a.seq < b.seq;
+      case OverlapPolicy::most_specific:
+        if (Compare()(b.lo, a.lo)) return true;
+        if (Compare()(a.lo, b.lo)) return false;
+        if (a.open != b.open) return b.open;
+        if (!a.open && Compare()(a.hi, b.hi)) return true;
+        if (!a.open && Compare()(b.hi, a.hi)) return false;
+        return a.seq > b.seq;
+      default:
+        return a.seq > b.seq;
+    }
+  }
+
+  static void FillEytzinger(State& s, const std::vector<Key>& sorted,
+                            const std::vector<std::int32_t>& before,
+                            std::size_t& i, std::size_t k) {
+    if (k >= s.keys.size()) return;
+    FillEytzinger(s, sorted, before, i, 2 * k);
+    s.keys[k] = sorted[i];
+    s.before[k] = before[i];
+    ++i;
+    FillEytzinger(s, sorted, before, i, 2 * k + 1);
+  }
+
+  /// Flattens the intervals into resolved segments and lays them out
+  static void BuildIndex(State& s) {
+    const std::vector<Interval>& intervals = s.intervals;
+
+    // Boundary events: interval i starts at its lo and ends at its hi.
+    std::vector<std::pair<Key, std::int32_t>> events;
+    for (std::size_t i = 0; i < intervals.size(); ++i) {
+      auto idx = static_cast<std::int32_t>(i);
+      events.emplace_back(intervals[i].lo, idx);
+      if (!intervals[i].open) events.emplace_back(intervals[i].hi, ~idx);
+    }
+    std::sort(events.begin(), events.end(),
+              [](const std::pair<Key, std::int32_t>& a,
+                 const std::pair<Key, std::int32_t>& b) {
+                return Compare()(a.first, b.first);
+              });
+
+    auto cmp = [&intervals](std::int32_t a, std::int32_t b) {
+      return Preferred(intervals[a], intervals[b]);
+    };
+    std::set<std::int32_t, decltype(cmp)> active(cmp);
+
+    // Sweep the boundaries in order; the best active interval after applying
+    // all events at a boundary covers the segment starting there.
+    std::vector<Key> sorted;
+    std::vector<std::int32_t> before;
+    std::int32_t current = kNone;
+    for (std::size_t e = 0; e < events.size();) {
+      std::size_t end = e;
+      while (end < events.size() && Equivalent(events[end].first,
+                                               events[e].first)) {
+        std::int32_t idx = events[end].second;
+        if (idx >= 0) {
+          active.insert(idx);
+        } else {
+          active.erase(~idx);
+        }
+        ++end;
+      }
+      sorted.push_back(events[e].first);
+      before.push_back(current);
+      current = active.empty() ? kNone : *active.begin();
+      e = end;
+    }
+
+    s.keys.assign(sorted.size() + 1, Key());
+    s.before.assign(sorted.size() + 1, kNone);
+    std::size_t i = 0;
+    FillEytzinger(s, sorted, before, i, 1);
+    s.tail = current;
+  }
+
+  static const func_t* Find(const Key& value) {
+    State& s = state();
+    if (!s.index_valid.load(std::memory_order_acquire)) {
+      detail::CheckedLock<std::lock_guard<std::mutex>> lock(s.index_mutex);
+      if (!s.index_valid.load(std::memory_order_relaxed)) {
+        BuildIndex(s);
+        s.index_valid.store(true, std::memory_order_release);
+      }
+    }
+
+    // Find the first boundary greater than value. The descent goes right
+    // whenever the boundary is <= value; stripping the trailing right turns
+    // (and the final left turn) from k yields that boundary's slot, or 0 if
+    // every boundary is <= value.
+    const std::size_t n = s.keys.size();
+    std::size_t k = 1;
+    while (k < n) k = 2 * k + (Compare()(value, s.keys[k]) ? 0 : 1);
+    while (k & 1u) k >>= 1;
+    k >>= 1;
+
+    std::int32_t idx = k == 0 ? s.tail : s.before[k];
+    return idx == kNone ? nullptr : &s.intervals[idx].func;
+  }
+};
+
+}
@@ -0,0 +1,72 @@
+/** Interface file for the KeyCodec class template, the byte representation
+ *  of keys shared by SharedKeyIndex, KeyProfile, MemoCache and the C ABI
+ *
+ *  Only standard headers are included, so this file is usable on every
+ *  platform, unlike the POSIX-only shared_key_index.h.
+ *
+ *  \file key_codec.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace registry {
+
+/// A view of the bytes that identify a key across processes
+struct KeyBytes {
+  const void* data;
+  std::size_t size;
+};
+
+/** Maps keys to a byte representation that is the same in every process,
+ *  as needed by SharedKeyIndex, and back (Decode() is only needed to read
+ *  keys from files, see KeyProfile). Provided for arithmetic and enum types
+ *  and for `std::string`; specialise it for other key types.
+ */
+template <class Key, class = void>
+struct KeyCodec;
+
+template <class Key>
+struct KeyCodec<Key, typename std::enable_if<std::is_arithmetic<Key>::value ||
+                                             std::is_enum<Key>::value>::type> {
+  static KeyBytes Encode(const Key& key) { return {&key, sizeof(Key)}; }
+  static bool Decode(const void* data, std::size_t size, Key* key) {
+    if (size != sizeof(Key)) return false;
+    std::memcpy(key, data, sizeof(Key));
+    return true;
+  }
+};
+
+template <>
+struct KeyCodec<std::string> {
+  static KeyBytes Encode(const std::string& key) {
+    return {key.data(), key.size()};
+  }
+  static bool Decode(const void* data, std::size_t size, std::string* key) {
+    key->assign(static_cast<const char*>(data), size);
+    return true;
+  }
+};
+
+namespace detail {
+
+/// 64-bit FNV-1a, stable across processes, builds and platforms; pass a
+/// previous result as `hash` to hash several byte ranges in sequence
+inline std::uint64_t StableHash(KeyBytes bytes,
+                                std::uint64_t hash = 0xcbf29ce484222325ULL) {
+  const unsigned char* p = static_cast<const unsigned char*>(bytes.data);
+  for (std::size_t i = 0; i < bytes.size; ++i) {
+    hash = (hash ^ p[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+}
+
+}
@@ -0,0 +1,373 @@
+/** Interface file for the MemoizedRegistry class template
+ *
+ *  \file memo_cache.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cppregpattern/shared_key_index.h"
+
+namespace registry {
+
+/** Converts results of memoized functions to bytes and back, see
+ *  MemoizedRegistry. The default uses the members
+ *
+ *  \code{.cpp}
+ *  void Serialize(std::string* out) const;
+ *  static T Deserialize(const char* data, std::size_t size);
+ *  \endcode
+ *
+ *  of the result type; specialisations are provided for arithmetic types and
+ *  `std::string`. Deserialize() may keep pointers into `data`, which stays
+ *  valid for the lifetime of the MemoizedRegistry.
+ */
+template <class T, class = void>
+struct MemoCodec {
+  static void Serialize(const T& value, std::string* out) {
+    value.Serialize(out);
+  }
+  static T Deserialize(const char* data, std::size_t size) {
+    return T::Deserialize(data, size);
+  }
+};
+
+template <class T>
+struct MemoCodec<T,
+                 typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  static void Serialize(const T& value, std::string* out) {
+    out->assign(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  static T Deserialize(const char* data, std::size_t) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+};
+
+template <>
+struct MemoCodec<std::string> {
+  static void Serialize(const std::string& value, std::string* out) {
+    *out = value;
+  }
+  static std::string Deserialize(const char* data, std::size_t size) {
+    return std::string(data, size);
+  }
+};
+
+namespace detail {
+
+constexpr char kMemoMagic[8] = {'C', 'R', 'P', 'M', 'E', 'M', 'O', 0};
+constexpr std::uint32_t kMemoFormat = 1;
+
+/// Layout of a memo file: the header, then entries, each a MemoEntryHeader
+/// followed by the KeyCodec bytes of the key and the serialised result,
+/// both padded to 8 bytes
+struct MemoFileHeader {
+  char magic[8];
+  std::uint32_t format;
+  std::uint32_t reserved;
+  std::uint64_t build_id;
+};
+
+struct MemoEntryHeader {
+  std::uint64_t key_size;
+  std::uint64_t args_hash;
+  std::uint64_t data_size;
+};
+
+inline std::uint64_t MemoPadded(std::uint64_t size) {
+  return (size + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+}
+
+/** Memoizes the results of expensive, pure functions of a registry in a file,
+ *  so that they survive restarts.
+ *
+ *  \par
+ *  Results are stored under the key, a stable hash of the arguments and a
+ *  build id chosen by the caller (e.g. a hash of the plugin versions): a
+ *  file written with another build id is discarded when opened. Results of
+ *  earlier runs are handed to MemoCodec::Deserialize() straight from a
+ *  mapping of the file, without copies; new results are appended to the
+ *  file and kept in memory. A result is computed
+ *  at most once per argument set, unless two threads miss at the same time.
+ *
+ *  \code{.cpp}
+ *  using Compilers = BasicRegistry<std::string, RuleSet(const std::string&)>;
+ *  MemoizedRegistry<Compilers> rules(compilers, "/var/cache/rules.memo",
+ *                                    kPluginBuildId);
+ *  RuleSet set = rules.Dispatch("firewall", config_text);
+ *  \endcode
+ *
+ *  \par
+ *  Arguments are hashed through their KeyCodec, so each argument type needs
+ *  a KeyCodec specialisation; two argument sets with the same 64-bit hash
+ *  share an entry. The first MemoizedRegistry to open a file holds an
+ *  exclusive flock() on it until destroyed; others opening the same file
+ *  meanwhile, in any process, neither read nor write it and keep their
+ *  results in memory only.
+ *
+ *  \tparam Base  The memoized registry type, e.g. a BasicRegistry
+ */
+template <class Base>
+class MemoizedRegistry {
+ public:
+  using key_type = typename Base::key_type;
+  using func_t = typename Base::func_t;
+  using result_type = typename Base::result_type;
+  using missing_key_t = typename Base::missing_key_t;
+  using ret_t = typename Base::ret_t;
+  using codec_t = MemoCodec<result_type>;
+
+  /** Opens or creates the memo file at `path`
+   *
+   *  \param base      The registry whose results are memoized; it must
+   *                   outlive this object
+   *  \param path      The memo file
+   *  \param build_id  Identifies the registered code; a file written with
+   *                   another value is emptied
+   *
+   *  \throws std::runtime_error if the file cannot be opened, created or
+   *          mapped
+   */
+  MemoizedRegistry(const Base& base, const std::string& path,
+                   std::uint64_t build_id)
+      : base_(base) {
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) Fail("cannot open " + path);
+    if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+      // Another MemoizedRegistry owns the file and may append to it
+      close(fd_);
+      fd_ = -1;
+      writable_ = false;
+      return;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+      Release();
+      Fail("cannot stat " + path);
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size > sizeof(Header)) {
+      void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (p == MAP_FAILED) {
+        // Never discard a possibly valid memo because of a mapping failure
+        Release();
+        Fail("cannot map " + path);
+      }
+      map_ = static_cast<const char*>(p);
+      map_size_ = size;
+    }
+    end_ = map_ != nullptr ? Load(build_id) : 0;
+    if (end_ == 0) {
+      if (map_ != nullptr) munmap(const_cast<char*>(map_), map_size_);
+      map_ = nullptr;
+      Header header;
+      std::memcpy(header.magic, detail::kMemoMagic, sizeof(header.magic));
+      header.format = detail::kMemoFormat;
+      header.reserved = 0;
+      header.build_id = build_id;
+      if (ftruncate(fd_, 0) != 0 ||
+          pwrite(fd_, &header, sizeof(header), 0) !=
+              static_cast<ssize_t>(sizeof(header))) {
+        Release();
+        Fail("cannot write " + path);
+      }
+      end_ = sizeof(header);
+    } else if (end_ < size && ftruncate(fd_, static_cast<off_t>(end_)) != 0) {
+      end_ = size;  // Keep the torn tail; it is skipped again on next open
+      writable_ = false;
+    }
+  }
+
+  MemoizedRegistry(const MemoizedRegistry&) = delete;
+  MemoizedRegistry& operator=(const MemoizedRegistry&) = delete;
+
+  ~MemoizedRegistry() { Release(); }
+
+  /** Returns the memoized result of `key` for `args`, calling the registered
+   *  function and storing its result on a miss
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments of the function, each with a KeyCodec
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const key_type& key, const Args&... args) {
+    const func_t* func = base_.Find(key);
+    if (func == nullptr) {
+      return missing_key_t::Handle(
+          "registry::MemoizedRegistry::Dispatch: unknown key");
+    }
+    std::string id = EntryId(key, args...);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(id);
+      if (it != index_.end()) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return codec_t::Deserialize(it->second.data, it->second.size);
+      }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    result_type result = (*func)(args...);
+    std::string data;
+    codec_t::Serialize(result, &data);
+    Store(id, std::move(data));
+    return ret_t(std::move(result));
+  }
+
+  /// Number of Dispatch() calls answered from the memo
+  std::size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+
+  /// Number of Dispatch() calls that ran the registered function
+  std::size_t misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  /// Number of memoized results
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+  }
+
+ private:
+  using Header = detail::MemoFileHeader;
+  using EntryHeader = detail::MemoEntryHeader;
+
+  struct View {
+    const char* data;
+    std::size_t size;
+  };
+
+  [[noreturn]] static void Fail(const std::string& what) {
+    throw std::runtime_error("registry::MemoizedRegistry: " + what);
+  }
+
+  /// The key's bytes followed by the hash of the arguments
+  template <typename... Args>
+  static std::string EntryId(const key_type& key, const Args&... args) {
+    std::uint64_t hash = detail::StableHash({nullptr, 0});
+    std::uint64_t sizes[] = {0, Mix(&hash, args)...};
+    static_cast<void>(sizes);
+    KeyBytes bytes = KeyCodec<key_type>::Encode(key);
+    std::string id(static_cast<const char*>(bytes.data), bytes.size);
+    id.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    return id;
+  }
+
+  template <class Arg>
+  static std::uint64_t Mix(std::uint64_t* hash, const Arg& arg) {
+    KeyBytes bytes = KeyCodec<Arg>::Encode(arg);
+    std::uint64_t size = bytes.size;
+    *hash = detail::StableHash({&size, sizeof(size)}, *hash);
+    *hash = detail::StableHash(bytes, *hash);
+    return size;
+  }
+
+  /// Indexes the entries of a mapped file of build `build_id`
+  ///
+  /// \return The end of the last complete entry, or 0 if the file is invalid
+  std::size_t Load(std::uint64_t build_id) {
+    const Header* header = reinterpret_cast<const Header*>(map_);
+    if (std::memcmp(header->magic, detail::kMemoMagic,
+                    sizeof(header->magic)) != 0 ||
+        header->format != detail::kMemoFormat ||
+        header->build_id != build_id) {
+      return 0;
+    }
+    std::size_t offset = sizeof(Header);
+    while (map_size_ - offset >= sizeof(EntryHeader)) {
+      EntryHeader entry;
+      std::memcpy(&entry, map_ + offset, sizeof(entry));
+      std::uint64_t key_size = detail::MemoPadded(entry.key_size);
+      std::uint64_t data_size = detail::MemoPadded(entry.data_size);
+      std::uint64_t left = map_size_ - offset - sizeof(EntryHeader);
+      if (entry.key_size > left || entry.data_size > left ||
+          key_size + data_size > left) {
+        break;
+      }
+      const char* key = map_ + offset + sizeof(EntryHeader);
+      std::string id(key, static_cast<std::size_t>(entry.key_size));
+      id.append(reinterpret_cast<const char*>(&entry.args_hash),
+                sizeof(entry.args_hash));
+      index_[id] = View{key + key_size,
+                        static_cast<std::size_t>(entry.data_size)};
+      offset += sizeof(EntryHeader) + key_size + data_size;
+    }
+    return offset;
+  }
+
+  /// Keeps `data` in memory and appends it to the file
+  void Store(const std::string& id, std::string data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(id) == 1u) return;
+    fresh_.push_back(std::move(data));
+    const std::string& stored = fresh_.back();
+    index_[id] = View{stored.data(), stored.size()};
+    if (!writable_) return;
+
+    std::size_t key_size = id.size() - sizeof(std::uint64_t);
+    EntryHeader entry;
+    entry.key_size = key_size;
+    std::memcpy(&entry.args_hash, id.data() + key_size, sizeof(std::uint64_t));
+    entry.data_size = stored.size();
+    std::string record(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    record.append(id, 0, key_size);
+    record.resize(sizeof(entry) + detail::MemoPadded(key_size), '\0');
+    record.append(stored);
+    record.resize(record.size() + detail::MemoPadded(stored.size()) -
+                      stored.size(),
+                  '\0');
+    // The memo is best effort: a failed write only loses persistence, and
+    // a partial record is dropped when the file is next opened
+    ssize_t written = pwrite(fd_, record.data(), record.size(),
+                             static_cast<off_t>(end_));
+    if (written == static_cast<ssize_t>(record.size())) {
+      end_ += record.size();
+    } else {
+      writable_ = false;
+    }
+  }
+
+  void Release() {
+    if (map_ != nullptr) munmap(const_cast<char*>(map_), map_size_);
+    if (fd_ >= 0) close(fd_);
+    map_ = nullptr;
+    fd_ = -1;
+  }
+
+  const Base& base_;
+  int fd_ = -1;
+  const char* map_ = nullptr;
+  std::size_t map_size_ = 0;
+  std::size_t end_ = 0;  // File offset of the next record
+  bool writable_ = true;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, View> index_;
+  std::deque<std::string> fresh_;  // Results computed by this process
+  std::atomic<std::size_t> hits_{0};
+  std::atomic<std::size_t> misses_{0};
+};
+
+}
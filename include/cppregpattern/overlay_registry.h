@@ -0,0 +1,218 @@
+/** Interface file for the OverlayRegistry class template
+ *
+ *  \file overlay_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/** A copy-on-write view of a sealed BasicRegistry that stores only the
+ *  changes made on top of it: overriding registrations and tombstones for
+ *  unregistered keys. Creating an overlay does not copy the base, so it takes
+ *  constant time and its memory grows with the number of overrides only,
+ *  making it cheap to give every tenant its own variant of a large global
+ *  registry.
+ *
+ *  \par
+ *  The overrides are kept in a small open-addressing table fronted by a
+ *  256-bit Bloom filter. A lookup hashes the key once and uses that hash for
+ *  the filter test, for the probe of the override table when the filter
+ *  matches, and for the probe of the base's index otherwise, so keys that
+ *  are not overridden cost a couple of bit tests on top of a plain lookup in
+ *  the base. The base must be sealed (see
+ *  BasicRegistry::Seal()) and outlive the overlay. Like the default
+ *  NoLockPolicy, concurrent Dispatch() calls are fine, but do not modify the
+ *  overlay while it is being dispatched from.
+ *
+ *  \code{.cpp}
+ *  GlobalHandlers::Seal();
+ *  OverlayRegistry<GlobalHandlers::instance_t> tenant(
+ *      GlobalHandlers::Instance());
+ *  tenant.Register("echo", [] { return MakeTenantEcho(); });
+ *  tenant.Unregister("debug");
+ *  \endcode
+ *
+ *  \tparam Base  The BasicRegistry type being overlaid
+ */
+template <class Base>
+class OverlayRegistry {
+ public:
+  using key_type = typename Base::key_type;
+  using func_t = typename Base::func_t;
+  using missing_key_t = typename Base::missing_key_t;
+  using ret_t = typename Base::ret_t;
+
+  /** Creates an empty overlay of `base`
+   *
+   *  \throws std::invalid_argument if `base` is not sealed
+   */
+  explicit OverlayRegistry(const Base& base) : base_(&base) {
+    if (!base.IsSealed()) {
+      throw std::invalid_argument(
+          "registry::OverlayRegistry: the base registry must be sealed");
+    }
+  }
+
+  /** Calls the function registered under `key` in the overlay, or in the
+   *  base if the overlay neither overrides nor removes it
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const key_type& key, Args&&... args) const {
+    CPPREGPATTERN_RT_SCOPE("registry::OverlayRegistry::Dispatch");
+    const func_t* func = Find(key);
+    if (func == nullptr) {
+      return missing_key_t::Handle(
+          "registry::OverlayRegistry::Dispatch: unknown key");
+    }
+    return (*func)(std::forward<Args>(args)...);
+  }
+
+  /** Register a function in the overlay, overriding the base
+   *
+   *  \param key   The identifier under which to register this function
+   *  \param func  Function to register
+   *
+   *  \return Whether registration is successful
+   */
+  bool Register(const key_type& key, const func_t& func) {
+    Put(key, func, false);
+    return true;
+  }
+
+  /// Hides the given identifier, whether it comes from the base or not
+  void Unregister(const key_type& key) { Put(key, func_t(), true); }
+
+  /// Drops the overlay's override or tombstone for `key`, if any
+  void Revert(const key_type& key) {
+    std::size_t hash = Hasher()(key);
+    std::int32_t idx = Probe(key, hash);
+    if (idx < 0) return;
+    entries_.erase(entries_.begin() + idx);
+    Reindex();
+  }
+
+  /// Test whether the given identifier is registered
+  bool IsRegistered(const key_type& key) const {
+    return Find(key) != nullptr;
+  }
+
+  /// Returns the function visible under `key`, or nullptr
+  const func_t* Find(const key_type& key) const {
+    std::size_t hash = Hasher()(key);
+    if (MayContain(hash)) {
+      std::int32_t idx = Probe(key, hash);
+      if (idx >= 0) {
+        const Entry& entry = entries_[idx];
+        return entry.tombstone ? nullptr : &entry.func;
+      }
+    }
+    return base_->Find(key, hash);
+  }
+
+  /// The registry this overlay is layered over
+  const Base& base() const { return *base_; }
+
+  /// Number of overrides and tombstones held by the overlay
+  std::size_t size() const { return entries_.size(); }
+
+ private:
+  using Hasher = typename Base::hasher;
+  using KeyEqual = typename Base::key_equal;
+
+  struct Entry {
+    key_type key;
+    std::size_t hash;
+    func_t func;
+    bool tombstone;
+  };
+
+  static constexpr std::int32_t kEmpty = -1;
+
+  // Two filter bits per key, taken from the top bits of the mixed hash so
+  // they are independent of the low bits used for the table index.
+  static std::uint64_t Mix(std::size_t hash) {
+    return static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+  }
+  bool MayContain(std::size_t hash) const {
+    std::uint64_t m = Mix(hash);
+    unsigned a = static_cast<unsigned>(m >> 56);
+    unsigned b = static_cast<unsigned>(m >> 48) & 0xffu;
+    return ((filter_[a / 64] >> (a % 64)) & 1u) &&
+           ((filter_[b / 64] >> (b % 64)) & 1u);
+  }
+  void AddToFilter(std::size_t hash) {
+    std::uint64_t m = Mix(hash);
+    unsigned a = static_cast<unsigned>(m >> 56);
+    unsigned b = static_cast<unsigned>(m >> 48) & 0xffu;
+    filter_[a / 64] |= std::uint64_t(1) << (a % 64);
+    filter_[b / 64] |= std::uint64_t(1) << (b % 64);
+  }
+
+  std::int32_t Probe(const key_type& key, std::size_t hash) const {
+    if (index_.empty()) return kEmpty;
+    std::size_t mask = index_.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+      std::int32_t idx = index_[i];
+      if (idx == kEmpty) return kEmpty;
+      const Entry& entry = entries_[idx];
+      if (entry.hash == hash && KeyEqual()(entry.key, key)) return idx;
+    }
+  }
+
+  void Put(const key_type& key, const func_t& func, bool tombstone) {
+    std::size_t hash = Hasher()(key);
+    std::int32_t idx = Probe(key, hash);
+    if (idx >= 0) {
+      entries_[idx].func = func;
+      entries_[idx].tombstone = tombstone;
+      return;
+    }
+    entries_.push_back(Entry{key, hash, func, tombstone});
+    if (2 * entries_.size() > index_.size()) {
+      Reindex();
+    } else {
+      Insert(static_cast<std::int32_t>(entries_.size() - 1));
+    }
+  }
+
+  void Insert(std::int32_t idx) {
+    std::size_t mask = index_.size() - 1;
+    std::size_t i = entries_[idx].hash & mask;
+    while (index_[i] != kEmpty) i = (i + 1) & mask;
+    index_[i] = idx;
+    AddToFilter(entries_[idx].hash);
+  }
+
+  /// Rebuilds the table (at most half full) and the filter from entries_
+  void Reindex() {
+    std::size_t capacity = 8;
+    while (capacity < 2 * entries_.size()) capacity *= 2;
+    index_.assign(capacity, kEmpty);
+    for (std::uint64_t& word : filter_) word = 0;
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+      Insert(static_cast<std::int32_t>(i));
+    }
+  }
+
+  const Base* base_;
+  std::vector<Entry> entries_;
+  std::vector<std::int32_t> index_;
+  std::uint64_t filter_[4] = {0, 0, 0, 0};
+};
+
+}
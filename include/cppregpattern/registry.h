@@ -7,12 +7,32 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #if __cplusplus >= 201703L
 #include <optional>
+#include <shared_mutex>
+
+#include "cppregpattern/delegate.h"
+#endif
+
+#include "cppregpattern/rt_verify.h"
+
+#if __cplusplus >= 201402L
+#define CPPREGPATTERN_DEPRECATED(message) [[deprecated(message)]]
+#else
+#define CPPREGPATTERN_DEPRECATED(message)
 #endif
 
 namespace registry {
@@ -26,13 +46,1022 @@ enum class MissingKeyPolicy {
 #endif
 };
 
+namespace detail {
+
+/** Return type of Dispatch() and the value produced for a missing key under
+ *  each MissingKeyPolicy, for registries that do their own lookup.
+ *
+ *  \tparam MKP     The missing key policy
+ *  \tparam Result  The return type of the registered functions
+ */
+template <MissingKeyPolicy MKP, class Result>
+struct MissingKey;
+
+template <class Result>
+struct MissingKey<MissingKeyPolicy::exception, Result> {
+  using ret_t = Result;
+  static ret_t Handle(const char* what) { throw std::out_of_range(what); }
+};
+
+template <class Result>
+struct MissingKey<MissingKeyPolicy::default_construct, Result> {
+  using ret_t = Result;
+  static ret_t Handle(const char*) { return ret_t(); }
+};
+
+#if __cplusplus >= 201703L
+template <class Result>
+struct MissingKey<MissingKeyPolicy::optional, Result> {
+  using ret_t = std::optional<Result>;
+  static ret_t Handle(const char*) { return std::nullopt; }
+};
+#endif
+
+/// The callable type stored for `Func`: `std::function<Func>` for a
+/// function signature, or `Func` itself for a wrapper type such as
+/// UniqueFunction
+template <class Func>
+struct FunctionWrapper {
+  using type = Func;
+};
+
+template <class R, class... Args>
+struct FunctionWrapper<R(Args...)> {
+  using type = std::function<R(Args...)>;
+};
+
+/// The return type of a stored callable: its `result_type`, or the return
+/// type of a plain function pointer
+template <class F>
+struct CallableResult {
+  using type = typename F::result_type;
+};
+
+template <class R, class... Args>
+struct CallableResult<R (*)(Args...)> {
+  using type = R;
+};
+
+/** A table entry of BasicRegistry: a pointer to the stored function with its
+ *  type erased, so that the tables and their lookup code are shared by all
+ *  registries with the same key type, hash, key equality and allocator,
+ *  whatever their function types. Atomic so that a lazy entry can be
+ *  patched in place while other threads dispatch. When the stored function
+ *  is a plain function pointer, the slot also holds a copy of it in `code`,
+ *  which Dispatch() calls without going through the stored object.
+ */
+struct Slot {
+  Slot(const void* f = nullptr, void (*c)() = nullptr)  // NOLINT: implicit
+      : func(f), code(c) {}
+  Slot(const Slot& other) : func(other.get()), code(other.code) {}
+  Slot& operator=(const Slot& other) {
+    func.store(other.get(), std::memory_order_relaxed);
+    code = other.code;
+    return *this;
+  }
+  const void* get() const { return func.load(std::memory_order_acquire); }
+
+  std::atomic<const void*> func;
+  void (*code)();
+};
+
+/// Compares a key stored in a SlotIndex with a lookup key
+using KeyCompare = bool (*)(const void* stored, const void* key);
+
+template <class KeyEqual, class Key, class LookupKey>
+bool CompareKeys(const void* stored, const void* key) {
+  return KeyEqual()(*static_cast<const Key*>(stored),
+                    *static_cast<const LookupKey*>(key));
+}
+
+/** A flat open-addressing index over the entries of a registry table,
+ *  holding each key's hash and pointers to the key and slot in the table's
+ *  nodes. It lets a caller that already hashed a key (such as an
+ *  OverlayRegistry) find the slot without hashing again, and its probe is a
+ *  single non-template routine shared by all registries.
+ */
+class SlotIndex {
+ public:
+  /// Adds a key that is not in the index yet
+  void Insert(std::size_t hash, const void* key, const Slot* slot) {
+    if (2 * (size_ + 1) > cells_.size()) Grow();
+    Place(Cell{hash, key, slot});
+    ++size_;
+  }
+
+  /// Removes the key stored at `key`, if present
+  void Erase(std::size_t hash, const void* key) {
+    if (cells_.empty()) return;
+    std::size_t mask = cells_.size() - 1;
+    std::size_t i = Home(hash);
+    while (cells_[i].key != key) {
+      if (cells_[i].slot == nullptr) return;
+      i = (i + 1) & mask;
+    }
+    // Backward-shift deletion keeps probe sequences free of gaps
+    for (std::size_t j = (i + 1) & mask; cells_[j].slot != nullptr;
+         j = (j + 1) & mask) {
+      std::size_t home = Home(cells_[j].hash);
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        cells_[i] = cells_[j];
+        i = j;
+      }
+    }
+    cells_[i] = Cell();
+    --size_;
+  }
+
+  /// Returns the slot whose key equals `key`, or nullptr, and the stored
+  /// key in `*stored_key` if given
+  const Slot* Find(std::size_t hash, const void* key, KeyCompare equal,
+                   const void** stored_key = nullptr) const {
+    if (cells_.empty()) return nullptr;
+    std::size_t mask = cells_.size() - 1;
+    for (std::size_t i = Home(hash);; i = (i + 1) & mask) {
+      const Cell& cell = cells_[i];
+      if (cell.slot == nullptr) return nullptr;
+      if (cell.hash == hash && equal(cell.key, key)) {
+        if (stored_key != nullptr) *stored_key = cell.key;
+        return cell.slot;
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    Cell() : hash(0), key(nullptr), slot(nullptr) {}
+    Cell(std::size_t h, const void* k, const Slot* s)
+        : hash(h), key(k), slot(s) {}
+
+    std::size_t hash;
+    const void* key;
+    const Slot* slot;  // nullptr marks an empty cell
+  };
+
+  std::size_t Home(std::size_t hash) const {
+    std::uint64_t mixed =
+        static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<std::size_t>(mixed >> shift_);
+  }
+
+  void Place(const Cell& cell) {
+    std::size_t mask = cells_.size() - 1;
+    std::size_t i = Home(cell.hash);
+    while (cells_[i].slot != nullptr) i = (i + 1) & mask;
+    cells_[i] = cell;
+  }
+
+  void Grow() {
+    std::vector<Cell> old(cells_.empty() ? 16 : 2 * cells_.size());
+    old.swap(cells_);
+    shift_ = 64;
+    for (std::size_t n = cells_.size(); n > 1; n /= 2) --shift_;
+    for (const Cell& cell : old) {
+      if (cell.slot != nullptr) Place(cell);
+    }
+  }
+
+  std::vector<Cell> cells_;
+  std::size_t size_ = 0;
+  unsigned shift_ = 64;
+};
+
+/** One published state of a BasicRegistry: its table, the index over the
+ *  table's nodes and its version number. It depends on the key type, hash,
+ *  key equality and allocator only, like the table itself.
+ */
+template <class Table, class Hash>
+struct Version {
+  using key_type = typename Table::key_type;
+
+  Version(const Table& t, std::uint64_t n) : table(t), number(n) {
+    for (const auto& entry : table) {
+      index.Insert(Hash()(entry.first), &entry.first, &entry.second);
+    }
+  }
+
+  /// Sets the slot of `key`, adding the key if needed
+  void Put(const key_type& key, const Slot& slot) {
+    auto inserted = table.emplace(key, slot);
+    if (!inserted.second) {
+      inserted.first->second = slot;
+    } else {
+      index.Insert(Hash()(key), &inserted.first->first,
+                   &inserted.first->second);
+    }
+  }
+
+  /// Removes `key`, returning whether it was present
+  bool Erase(const key_type& key) {
+    auto it = table.find(key);
+    if (it == table.end()) return false;
+    index.Erase(Hash()(key), &it->first);
+    table.erase(it);
+    return true;
+  }
+
+  Table table;
+  SlotIndex index;
+  std::atomic<std::uint64_t> number;
+};
+
+/// Destroys a function stored by a BasicRegistry, whose type it erases
+struct ErasedDeleter {
+  void operator()(void* func) const { destroy(func, context); }
+
+  void (*destroy)(void* func, void* context);
+  void* context;
+};
+
+/// A function owned by a BasicRegistry, with its type erased
+using OwnedFunc = std::unique_ptr<void, ErasedDeleter>;
+
+/// Enables the heterogeneous lookup overloads for `LookupKey` when Hash and
+/// KeyEqual are transparent and `LookupKey` is not simply convertible to Key
+template <class LookupKey, class Key, class Hash, class KeyEqual,
+          class = typename Hash::is_transparent,
+          class = typename KeyEqual::is_transparent>
+struct enable_heterogeneous
+    : std::enable_if<
+          !std::is_convertible<const LookupKey&, const Key&>::value> {};
+
+}
+
+/** Concurrency policy that does no locking. Multiple threads can call
+ *  Dispatch() at the same time, but Register() and Unregister() must not run
+ *  concurrently with any other call on the same registry.
+ */
+struct NoLockPolicy {
+  struct mutex_type {};
+  struct read_lock {
+    explicit read_lock(mutex_type&) {}
+  };
+  using write_lock = read_lock;
+};
+
+#if __cplusplus >= 201703L
+/** Concurrency policy guarding the registry with a `std::shared_mutex`, so
+ *  that registration may happen while other threads dispatch. Dispatch()
+ *  holds a shared lock only while it looks the key up, not while the
+ *  registered function runs.
+ */
+struct SharedMutexPolicy {
+  using mutex_type = std::shared_mutex;
+  using read_lock = detail::CheckedLock<std::shared_lock<std::shared_mutex>>;
+  using write_lock = detail::CheckedLock<std::unique_lock<std::shared_mutex>>;
+};
+#endif
+
+/** A map of functions, allowing for dynamic dispatching based on some
+ *  identifier. This is the non-static counterpart of Registry, with the same
+ *  Register() / Dispatch() interface and policies: each object owns its own
+ *  map, allocator and lock, so separate instances can be created per tenant,
+ *  per thread or per shard without sharing state or cache lines. Registry
+ *  itself is a thin wrapper around one global instance of this class.
+ *
+ *  \code{.cpp}
+ *  using TenantRegistry =
+ *      BasicRegistry<std::string, std::unique_ptr<Handler>()>;
+ *  TenantRegistry handlers;
+ *  handlers.Register("echo", [] { return MakeEchoHandler(); });
+ *  auto handler = handlers.Dispatch("echo");
+ *  \endcode
+ *
+ *  \par
+ *  Registered functions are stored once, in stable storage, and the map
+ *  (a "version" of the registry) only holds pointers to them. Register() and
+ *  Unregister() edit the current version in place. A Transaction instead
+ *  collects any number of changes, and Commit() applies them to a copy of the
+ *  current version and publishes it with a single atomic pointer swap, so
+ *  concurrent Dispatch() calls see either all of the changes or none of them
+ *  and never wait for the rebuild. Version() identifies the published state
+ *  for external caches. Functions and versions replaced this way, including
+ *  the copy of the table made by each Commit(), are kept alive until
+ *  Reclaim(), so that dispatches still running them are not affected; call
+ *  it after changes, at a point where such dispatches have finished. With
+ *  NoLockPolicy, where no dispatch runs during a change, the function that
+ *  Register(), Alias() or Unregister() replaces is destroyed right away
+ *  instead, as it would be in a plain map, unless an alias still refers to
+ *  it; only Commit() keeps what it replaces until Reclaim().
+ *
+ *  \par
+ *  `Func` is either a function signature, stored as `std::function<Func>`,
+ *  a callable wrapper type such as UniqueFunction, which allows move-only
+ *  targets, or a plain function pointer type, which Dispatch() calls
+ *  directly. Each function is stored in its own block obtained from
+ *  `Allocator`, and Emplace() constructs it there in place, passing the
+ *  allocator on to wrappers that accept one.
+ *
+ *  \tparam Key          The identifier type for the function map
+ *  \tparam Func         The function signature or callable wrapper type
+ *  \tparam MKP          The behavior policy for what to do in the case of a
+ *                       missing key
+ *  \tparam Hash         The hash function to use for the function map
+ *  \tparam KeyEqual     The key equality function for the function map
+ *  \tparam Allocator    The allocator for the function map and functions
+ *  \tparam Concurrency  The locking policy, NoLockPolicy or SharedMutexPolicy
+ */
+template <
+    class Key, class Func, MissingKeyPolicy MKP = MissingKeyPolicy::exception,
+    class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+    class Allocator = std::allocator<
+        std::pair<const Key, typename detail::FunctionWrapper<Func>::type>>,
+    class Concurrency = NoLockPolicy>
+class BasicRegistry {
+ public:
+  /// Function object used for constructing subclasses
+  using func_t = typename detail::FunctionWrapper<Func>::type;
+
+  using key_type = Key;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+
+  /// Return type of the registered functions
+  using result_type = typename detail::CallableResult<func_t>::type;
+
+  using missing_key_t = detail::MissingKey<MKP, result_type>;
+
+  /// Return type of Dispatch()
+  using ret_t = typename missing_key_t::ret_t;
+
+  /** A batch of changes applied atomically by BasicRegistry::Commit().
+   *  Operations are applied in the order they were added.
+   */
+  class Transaction {
+   public:
+    /// Registers (or replaces) a function
+    Transaction& Register(const Key& key, const func_t& func) {
+      ops_.push_back(Op{Op::kRegister, key, key, func});
+      return *this;
+    }
+
+    /// Registers (or replaces) a function, taking ownership of it
+    Transaction& Register(const Key& key, func_t&& func) {
+      ops_.push_back(Op{Op::kRegister, key, key, std::move(func)});
+      return *this;
+    }
+
+    /// Unregisters a key
+    Transaction& Unregister(const Key& key) {
+      ops_.push_back(Op{Op::kUnregister, key, key, func_t()});
+      return *this;
+    }
+
+    /// Makes `alias` dispatch to the function registered under `target`
+    Transaction& Alias(const Key& alias, const Key& target) {
+      ops_.push_back(Op{Op::kAlias, alias, target, func_t()});
+      return *this;
+    }
+
+    /// Whether no operations were added
+    bool empty() const { return ops_.empty(); }
+
+   private:
+    friend class BasicRegistry;
+
+    struct Op {
+      enum Kind { kRegister, kUnregister, kAlias } kind;
+      Key key;
+      Key target;
+      func_t func;
+    };
+
+    std::vector<Op> ops_;
+  };
+
+  explicit BasicRegistry(const Allocator& alloc = Allocator())
+      : current_(new version_t(
+            table_t(0, Hash(), KeyEqual(), table_alloc_t(alloc)),
+            NextVersion())),
+        func_alloc_(alloc) {
+    versions_.emplace_back(current_.load(std::memory_order_relaxed));
+  }
+
+  BasicRegistry(const BasicRegistry&) = delete;
+  BasicRegistry(BasicRegistry&&) noexcept = delete;
+  BasicRegistry& operator=(const BasicRegistry&) = delete;
+  BasicRegistry& operator=(BasicRegistry&&) noexcept = delete;
+
+  /** Calls one of the registered functions
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const Key& key, Args&&... args) const {
+    return DispatchImpl(key, std::forward<Args>(args)...);
+  }
+
+  /** Calls one of the registered functions, looking it up by a key of a
+   *  different type than `Key` (e.g. a tuple of `std::string_view`s for a
+   *  tuple of `std::string`s). Only available when both `Hash` and `KeyEqual`
+   *  are transparent (see TupleHash and TupleEqual). The registry's own index
+   *  is probed with the hash of `key`, so no `Key` is constructed and the
+   *  standard library's heterogeneous unordered lookup is not needed.
+   *
+   *  \param key   A key comparable with the identifiers passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <class LookupKey, typename... Args,
+            class H = Hash, class KE = KeyEqual,
+            class = typename detail::enable_heterogeneous<LookupKey, Key, H,
+                                                          KE>::type>
+  ret_t Dispatch(const LookupKey& key, Args&&... args) const {
+    return DispatchImpl(key, std::forward<Args>(args)...);
+  }
+
+  /// Test whether the given heterogeneous identifier is registered
+  template <class LookupKey,
+            class H = Hash, class KE = KeyEqual,
+            class = typename detail::enable_heterogeneous<LookupKey, Key, H,
+                                                          KE>::type>
+  bool IsRegistered(const LookupKey& key) const {
+    read_lock lock(mutex_);
+    return LookupSlot(key) != nullptr;
+  }
+
+  /** Register a function with the registry
+   *
+   *  \param key   The identifier under which to register this function
+   *  \param func  Function to register
+   *
+   *  \return Whether registration is successful (false once sealed)
+   */
+  bool Register(const Key& key, const func_t& func) {
+    return Emplace(key, func);
+  }
+
+  /// Register a function, taking ownership of it
+  bool Register(const Key& key, func_t&& func) {
+    return Emplace(key, std::move(func));
+  }
+
+#if __cplusplus >= 201703L
+  /** Register the member function `Method` of `obj` as a Delegate, without
+   *  allocating. `obj` is not owned and must outlive the registration.
+   *
+   *  \code{.cpp}
+   *  handlers.Register<&Server::Echo>("echo", server);
+   *  \endcode
+   */
+  template <auto Method, class C>
+  bool Register(const Key& key, C& obj) {
+    return Emplace(key, detail::BindMethod<Method, func_t>(obj));
+  }
+#endif
+
+  /** Register a function constructed in place from `func`, e.g. a lambda.
+   *  If `func_t` accepts an allocator (see UniqueFunction), the registry's
+   *  allocator is passed on for the callable's own storage.
+   *
+   *  \return Whether registration is successful (false once sealed)
+   */
+  template <class F>
+  bool Emplace(const Key& key, F&& func) {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    if (sealed_) return false;
+    detail::OwnedFunc owned = Own(MakeFunc(std::forward<F>(func)));
+    auto stored = static_cast<const func_t*>(owned.get());
+    funcs_.emplace(stored, std::move(owned));
+    write_lock lock(mutex_);
+    const func_t* replaced = concurrent_t::value ? nullptr : Lookup(key);
+    Put(Current(), key, stored);
+    Bump();
+    DestroyReplaced(replaced);
+    return true;
+  }
+
+#if __cplusplus >= 201703L
+  /** Register a function that is created on first use. The first Dispatch()
+   *  of `key` calls `init()`, which returns the real callable (anything
+   *  convertible to `func_t`); concurrent first callers wait for it, and if
+   *  it throws, the exception propagates and the next Dispatch() retries.
+   *  The entry is then patched to point at the callable, so later dispatches
+   *  take the normal path without any check.
+   *
+   *  \code{.cpp}
+   *  models.RegisterLazy("ranker", [] {
+   *    auto model = std::make_shared<Model>(LoadModel("ranker.bin"));
+   *    return [model](const Query& q) { return model->Score(q); };
+   *  });
+   *  \endcode
+   *
+   *  Not available when `func_t` is a plain function pointer, which cannot
+   *  hold the capturing trampoline; use a `std::function` registry instead.
+   *
+   *  \return Whether registration is successful (false once sealed)
+   */
+  template <class Init>
+  bool RegisterLazy(const Key& key, Init init) {
+    static_assert(!direct_call_t::value,
+                  "RegisterLazy needs a func_t that can hold a capturing "
+                  "callable, not a plain function pointer");
+    auto state = std::make_shared<LazyState<Init>>(key, std::move(init));
+    func_ptr trampoline = MakeFunc(
+        [this, state](auto&&... args) -> result_type {
+          return Resolve(*state)(std::forward<decltype(args)>(args)...);
+        });
+    state->trampoline = trampoline.get();
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    if (sealed_) return false;
+    funcs_.emplace(state->trampoline, Own(std::move(trampoline)));
+    write_lock lock(mutex_);
+    const func_t* replaced = concurrent_t::value ? nullptr : Lookup(key);
+    Put(Current(), key, state->trampoline);
+    Bump();
+    DestroyReplaced(replaced);
+    return true;
+  }
+#endif
+
+  /** Makes `alias` dispatch to the function registered under `target`
+   *
+   *  \return Whether `target` is registered and the registry is not sealed
+   */
+  bool Alias(const Key& alias, const Key& target) {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    if (sealed_) return false;
+    write_lock lock(mutex_);
+    const func_t* func = Lookup(target);
+    if (func == nullptr) return false;
+    aliased_.insert(func);
+    const func_t* replaced = concurrent_t::value ? nullptr : Lookup(alias);
+    Put(Current(), alias, func);
+    Bump();
+    DestroyReplaced(replaced);
+    return true;
+  }
+
+  /// Test whether the given identifier is registered
+  bool IsRegistered(const Key& key) const {
+    read_lock lock(mutex_);
+    return table().count(key) == 1u;
+  }
+
+  /** Unregisters the given identifier (no effect once sealed). With a
+   *  locking concurrency policy, the key is removed from a new version, so
+   *  that readers that do not hold the lock (see CachedRegistry) can still
+   *  compare with the old key until Reclaim(). With NoLockPolicy, the key is
+   *  removed in place and its function destroyed, unless an alias still
+   *  refers to it.
+   */
+  void Unregister(const Key& key) {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    if (sealed_) return;
+    if (!concurrent_t::value) {
+      write_lock lock(mutex_);
+      const func_t* removed = Lookup(key);
+      if (Current().Erase(key)) {
+        Bump();
+        DestroyReplaced(removed);
+      }
+      return;
+    }
+    if (table().count(key) == 0u) return;
+    std::unique_ptr<version_t> next(new version_t(table(), NextVersion()));
+    next->Erase(key);
+    write_lock lock(mutex_);
+    versions_.push_back(std::move(next));
+    current_.store(versions_.back().get(), std::memory_order_release);
+  }
+
+  /** Applies all operations of `txn` at once, as a new version
+   *
+   *  \par
+   *  The new version is built from a copy of the current one, without
+   *  blocking Dispatch(), and published atomically; it is rehashed to its
+   *  minimal bucket count if the registry is sealed. Commit() is allowed on
+   *  sealed registries. Aliases resolve against the state left by the
+   *  preceding operations.
+   *
+   *  \throws std::out_of_range if an alias target is not registered, in
+   *          which case nothing is applied
+   *
+   *  \return The new Version()
+   */
+  std::uint64_t Commit(Transaction txn) {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    std::unique_ptr<version_t> next(new version_t(table(), 0));
+    std::vector<detail::OwnedFunc> stored;
+    std::vector<const void*> aliased;
+    for (typename Transaction::Op& op : txn.ops_) {
+      switch (op.kind) {
+        case Transaction::Op::kRegister:
+          stored.push_back(Own(MakeFunc(std::move(op.func))));
+          Put(*next, op.key, static_cast<const func_t*>(stored.back().get()));
+          break;
+        case Transaction::Op::kUnregister:
+          next->Erase(op.key);
+          break;
+        case Transaction::Op::kAlias: {
+          auto it = next->table.find(op.target);
+          if (it == next->table.end()) {
+            throw std::out_of_range(
+                "registry::BasicRegistry::Commit: alias target not registered");
+          }
+          aliased.push_back(Stored(it->second));
+          Put(*next, op.key, Stored(it->second));
+          break;
+        }
+      }
+    }
+    if (sealed_) next->table.rehash(0);
+
+    for (auto& func : stored) funcs_.emplace(func.get(), std::move(func));
+    aliased_.insert(aliased.begin(), aliased.end());
+    std::uint64_t number = NextVersion();
+    next->number.store(number, std::memory_order_relaxed);
+    write_lock lock(mutex_);
+    versions_.push_back(std::move(next));
+    current_.store(versions_.back().get(), std::memory_order_release);
+    return number;
+  }
+
+  /** Identifies the current state of the registry. The number changes with
+   *  every Register(), Alias(), Unregister() and Commit(), and when a lazy
+   *  entry is patched (see RegisterLazy()); it is never reused by any
+   *  registry in the process.
+   */
+  std::uint64_t Version() const {
+    return current_.load(std::memory_order_acquire)
+        ->number.load(std::memory_order_acquire);
+  }
+
+  /** Frees the versions and functions that were replaced by Commit(),
+   *  Register() or Unregister(). Dispatch() does not hold any lock while the
+   *  registered function runs, so only call this when no thread can still be
+   *  running a replaced function or dispatching into an older version, e.g.
+   *  once the requests that were in flight during a config redeploy have
+   *  completed. With SharedMutexPolicy, it does wait for running lookups.
+   *  Until it is called, the memory of replaced functions and tables
+   *  accumulates.
+   */
+  void Reclaim() {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    write_lock lock(mutex_);
+    version_t* current = current_.load(std::memory_order_relaxed);
+    std::unordered_set<const void*> live;
+    for (const auto& entry : current->table) {
+      live.insert(Stored(entry.second));
+    }
+    // A patched lazy entry's function is owned by its trampoline. emplace()
+    // rather than insert(): GCC 12 crashes writing the C++20 module with it.
+    for (auto it = lazy_owners_.begin(); it != lazy_owners_.end();) {
+      if (live.count(it->first) == 1u) {
+        live.emplace(it->second);
+        ++it;
+      } else {
+        it = lazy_owners_.erase(it);
+      }
+    }
+    for (auto it = funcs_.begin(); it != funcs_.end();) {
+      it = live.count(it->first) == 1u ? std::next(it) : funcs_.erase(it);
+    }
+    for (auto it = aliased_.begin(); it != aliased_.end();) {
+      it = live.count(*it) == 1u ? std::next(it) : aliased_.erase(it);
+    }
+    for (auto& version : versions_) {
+      if (version.get() == current) {
+        version.release();
+        versions_.clear();
+        versions_.emplace_back(current);
+        break;
+      }
+    }
+  }
+
+  /** Returns the function registered under `key`, or nullptr. The pointer
+   *  stays valid until Reclaim() is called after the key was unregistered
+   *  or registered again; with NoLockPolicy, Register(), Alias() and
+   *  Unregister() of the key destroy it right away (see BasicRegistry).
+   */
+  const func_t* Find(const Key& key) const {
+    read_lock lock(mutex_);
+    return Lookup(key);
+  }
+
+  /** Find() for a caller that has already hashed `key`, such as an
+   *  OverlayRegistry: the lookup probes the registry's index with `hash`
+   *  directly and does not hash the key again
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param hash  `hasher()(key)`
+   */
+  const func_t* Find(const Key& key, std::size_t hash) const {
+    read_lock lock(mutex_);
+    return Lookup(key, hash);
+  }
+
+  /** Find() that also sets `*stored_key` to the registry's own copy of the
+   *  key, so that a cache can remember the key without copying it. The copy
+   *  stays valid while Version() is unchanged, and then until Reclaim().
+   */
+  const func_t* Find(const Key& key, std::size_t hash,
+                     const Key** stored_key) const {
+    read_lock lock(mutex_);
+    const void* stored = nullptr;
+    const detail::Slot* slot = LookupSlot(key, hash, &stored);
+    if (slot == nullptr) return nullptr;
+    *stored_key = static_cast<const Key*>(stored);
+    return Stored(*slot);
+  }
+
+  /** Calls `visitor(key, func)` for every registered key, where `func` is a
+   *  `const func_t*` with the same lifetime as those returned by Find().
+   *  Must not be called concurrently with changes to the registry.
+   */
+  template <class Visitor>
+  void ForEach(Visitor visitor) const {
+    for (const auto& entry : table()) {
+      visitor(entry.first, Stored(entry.second));
+    }
+  }
+
+  /// Number of registered keys
+  std::size_t size() const {
+    read_lock lock(mutex_);
+    return table().size();
+  }
+
+  /** Makes the registry read-only: later Register(), Alias() and
+   *  Unregister() calls fail or have no effect, leaving Commit() as the only
+   *  way to change it. The map is rehashed to its minimal bucket count first.
+   *  Sealed registries can serve as the base of an OverlayRegistry.
+   */
+  void Seal() {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    write_lock lock(mutex_);
+    MutableTable().rehash(0);
+    sealed_ = true;
+  }
+
+  /// Whether Seal() has been called
+  bool IsSealed() const {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    return sealed_;
+  }
+
+  /// Returns a copy of the allocator used by the function map
+  allocator_type get_allocator() const {
+    return allocator_type(table().get_allocator());
+  }
+
+ private:
+  using mutex_type = typename Concurrency::mutex_type;
+  using read_lock = typename Concurrency::read_lock;
+  using write_lock = typename Concurrency::write_lock;
+
+  using table_alloc_t = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<std::pair<const Key, detail::Slot>>;
+  using table_t =
+      std::unordered_map<Key, detail::Slot, Hash, KeyEqual, table_alloc_t>;
+
+  static const func_t* Stored(const detail::Slot& slot) {
+    return static_cast<const func_t*>(slot.get());
+  }
+
+  /// Whether `func_t` is a plain function pointer, called from the slot
+  using direct_call_t = std::integral_constant<
+      bool, std::is_pointer<func_t>::value &&
+                std::is_function<
+                    typename std::remove_pointer<func_t>::type>::value>;
+
+  static detail::Slot MakeSlot(const func_t* func) {
+    return MakeSlot(func, direct_call_t());
+  }
+  template <class F>
+  static detail::Slot MakeSlot(const F* func, std::true_type) {
+    return detail::Slot(func, reinterpret_cast<void (*)()>(*func));
+  }
+  template <class F>
+  static detail::Slot MakeSlot(const F* func, std::false_type) {
+    return detail::Slot(func);
+  }
+
+  template <typename... Args>
+  static ret_t Call(const detail::Slot& slot, std::true_type,
+                    Args&&... args) {
+    return reinterpret_cast<func_t>(slot.code)(std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  static ret_t Call(const detail::Slot& slot, std::false_type,
+                    Args&&... args) {
+    return (*Stored(slot))(std::forward<Args>(args)...);
+  }
+
+  using version_t = detail::Version<table_t, Hash>;
+
+  /// Whether Dispatch() may run concurrently with changes
+  using concurrent_t = std::integral_constant<
+      bool, !std::is_same<Concurrency, NoLockPolicy>::value>;
+
+  /// Registers `func` under `key` in `v`, replacing any previous function
+  static void Put(version_t& v, const Key& key, const func_t* func) {
+    v.Put(key, MakeSlot(func));
+  }
+
+  const detail::Slot* LookupSlot(const Key& key, std::size_t hash,
+                                 const void** stored_key = nullptr) const {
+    return current_.load(std::memory_order_acquire)
+        ->index.Find(hash, &key, &detail::CompareKeys<KeyEqual, Key, Key>,
+                     stored_key);
+  }
+  const detail::Slot* LookupSlot(const Key& key) const {
+    return LookupSlot(key, Hash()(key));
+  }
+  /// Heterogeneous keys: a transparent Hash hashes them like Key
+  template <class LookupKey>
+  const detail::Slot* LookupSlot(const LookupKey& key) const {
+    return current_.load(std::memory_order_acquire)
+        ->index.Find(Hash()(key), &key,
+                     &detail::CompareKeys<KeyEqual, Key, LookupKey>);
+  }
+
+  template <class LookupKey>
+  const func_t* Lookup(const LookupKey& key) const {
+    const detail::Slot* slot = LookupSlot(key);
+    return slot == nullptr ? nullptr : Stored(*slot);
+  }
+  const func_t* Lookup(const Key& key, std::size_t hash) const {
+    const detail::Slot* slot = LookupSlot(key, hash);
+    return slot == nullptr ? nullptr : Stored(*slot);
+  }
+
+  /// Version numbers are drawn from one process-wide counter so that a
+  /// number identifies both the registry and its state
+  static std::uint64_t NextVersion() {
+    static std::atomic<std::uint64_t> counter(0);
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  const table_t& table() const {
+    return current_.load(std::memory_order_acquire)->table;
+  }
+  table_t& MutableTable() {
+    return current_.load(std::memory_order_relaxed)->table;
+  }
+  version_t& Current() { return *current_.load(std::memory_order_relaxed); }
+  void Bump() {
+    current_.load(std::memory_order_relaxed)
+        ->number.store(NextVersion(), std::memory_order_release);
+  }
+
+  using func_alloc_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<func_t>;
+  using func_traits = std::allocator_traits<func_alloc_t>;
+
+  struct FuncDeleter {
+    func_alloc_t alloc;
+    void operator()(func_t* func) {
+      func_traits::destroy(alloc, func);
+      func_traits::deallocate(alloc, func, 1);
+    }
+  };
+  using func_ptr = std::unique_ptr<func_t, FuncDeleter>;
+
+  /** With NoLockPolicy, no call runs while a writer does, so the function
+   *  that a Register(), Alias() or Unregister() replaced is destroyed right
+   *  away, unless another key may still refer to it. With a locking policy,
+   *  it is kept until Reclaim() for the dispatches that may still run it.
+   */
+  void DestroyReplaced(const func_t* func) {
+    if (concurrent_t::value || func == nullptr || aliased_.count(func) == 1u) {
+      return;
+    }
+    const void* owner = func;
+    // A patched lazy entry's function is owned by its trampoline
+    auto lazy = lazy_owners_.find(func);
+    if (lazy != lazy_owners_.end()) {
+      owner = lazy->second;
+      if (aliased_.count(owner) == 1u) return;
+      lazy_owners_.erase(lazy);
+    }
+    funcs_.erase(owner);
+  }
+
+  /// Moves `func` into funcs_ storage, which is shared by all registries
+  detail::OwnedFunc Own(func_ptr func) {
+    return detail::OwnedFunc(func.release(),
+                             detail::ErasedDeleter{&Destroy, &func_alloc_});
+  }
+  static void Destroy(void* func, void* alloc) {
+    FuncDeleter{*static_cast<func_alloc_t*>(alloc)}(static_cast<func_t*>(func));
+  }
+
+  /// Constructs a function in a block from the registry's allocator
+  template <class F>
+  func_ptr MakeFunc(F&& func) {
+    func_t* p = func_traits::allocate(func_alloc_, 1);
+    try {
+      Construct(p, std::forward<F>(func),
+                std::is_constructible<func_t, std::allocator_arg_t,
+                                      const func_alloc_t&, F&&>());
+    } catch (...) {
+      func_traits::deallocate(func_alloc_, p, 1);
+      throw;
+    }
+    return func_ptr(p, FuncDeleter{func_alloc_});
+  }
+  template <class F>
+  void Construct(func_t* p, F&& func, std::true_type /* uses allocator */) {
+    func_traits::construct(func_alloc_, p, std::allocator_arg, func_alloc_,
+                           std::forward<F>(func));
+  }
+  template <class F>
+  void Construct(func_t* p, F&& func, std::false_type) {
+    func_traits::construct(func_alloc_, p, std::forward<F>(func));
+  }
+
+#if __cplusplus >= 201703L
+  template <class Init>
+  struct LazyState {
+    LazyState(const Key& k, Init i) : key(k), init(std::move(i)) {}
+
+    Key key;
+    Init init;
+    std::once_flag once;
+    func_ptr owned;
+    std::atomic<const func_t*> target{nullptr};
+    std::atomic<bool> patched{false};
+    const func_t* trampoline = nullptr;
+  };
+
+  /// Returns the callable of a lazy entry, creating it on first use
+  template <class Init>
+  const func_t& Resolve(LazyState<Init>& state) {
+    const func_t* target = state.target.load(std::memory_order_acquire);
+    if (target == nullptr) {
+      std::call_once(state.once, [&] {
+        state.owned = MakeFunc(state.init());
+        state.target.store(state.owned.get(), std::memory_order_release);
+      });
+      target = state.target.load(std::memory_order_acquire);
+    }
+    if (!state.patched.load(std::memory_order_acquire)) Patch(state, target);
+    return *target;
+  }
+
+  /// Points the lazy entry's slot at its callable
+  template <class Init>
+  void Patch(LazyState<Init>& state, const func_t* target) {
+    // Never make a dispatch wait for a writer here; a later dispatch
+    // retries if a writer holds writer_mutex_.
+    std::unique_lock<std::mutex> writer(writer_mutex_, std::try_to_lock);
+    if (!writer.owns_lock() || state.patched.load(std::memory_order_relaxed)) {
+      return;
+    }
+    table_t& t = MutableTable();
+    auto it = t.find(state.key);
+    if (it != t.end() && Stored(it->second) == state.trampoline) {
+      it->second.func.store(target, std::memory_order_release);
+      Bump();  // Caches keyed on Version() drop the trampoline
+    }
+    lazy_owners_[target] = state.trampoline;
+    state.patched.store(true, std::memory_order_release);
+  }
+#endif
+
+  template <class LookupKey, typename... Args>
+  ret_t DispatchImpl(const LookupKey& key, Args&&... args) const {
+    CPPREGPATTERN_RT_SCOPE("registry::Registry::Dispatch");
+    detail::Slot entry;
+    {
+      // With a locking policy, replaced functions stay alive until
+      // Reclaim(), so the lock is only needed for the lookup and writers
+      // never wait for running calls
+      read_lock lock(mutex_);
+      if (const detail::Slot* slot = LookupSlot(key)) entry = *slot;
+    }
+    if (entry.get() == nullptr) {
+      return missing_key_t::Handle("registry::Registry::Dispatch: unknown key");
+    }
+    return Call(entry, direct_call_t(), std::forward<Args>(args)...);
+  }
+
+  std::atomic<version_t*> current_;
+  std::vector<std::unique_ptr<version_t>> versions_;  // Current and retired
+  func_alloc_t func_alloc_;
+  std::unordered_map<const void*, detail::OwnedFunc> funcs_;  // By address
+  std::unordered_set<const void*> aliased_;  // Functions of several keys
+  std::unordered_map<const void*, const void*> lazy_owners_;
+  bool sealed_ = false;
+  mutable std::mutex writer_mutex_;
+  mutable mutex_type mutex_;
+};
+
 /** A self-registering map of functions, allowing for dynamic dispatching based
  *  on some identifier. Example usages may be constructing a subclass or using
  *  an appropriate I/O function based on an enum value or a string key. All
  *  functions in the map need to have the same signature in this implementation.
- *  Multiple threads can read from the map using Dispatch() at the same time,
- *  but do not call Register() and Dispatch() from different threads as the
- *  same time.
+ *  With the default NoLockPolicy, multiple threads can read from the map using
+ *  Dispatch() at the same time, but do not call Register() and Dispatch() from
+ *  different threads as the same time. SharedMutexPolicy lifts that
+ *  restriction.
  *
  *  \par
  *  Since the Registry template instantiation can be quite verbose and
@@ -50,8 +1079,8 @@ enum class MissingKeyPolicy {
  *  \endcode
  *
  *  The following policies for missing keys are supported:
- *  1. `MissingKeyPolicy::exception` - throws the `std::out_of_range` from
- *     `unordered_map`'s `at()` when the key does not exist.
+ *  1. `MissingKeyPolicy::exception` - throws `std::out_of_range` when the key
+ *     does not exist.
  *  2. `MissingKeyPolicy::default_construct` - returns a default-constructed
  *     object when the key does not exist.
  *  3. `MissingKeyPolicy::optional` - `Dispatch` now returns a `std::optional`
@@ -66,25 +1095,50 @@ enum class MissingKeyPolicy {
  *  -Wl,--whole-archive -lmylib -Wl,--no-whole-archive
  *  \endcode
  *
- *  \tparam Key        The identifier type for the function map
- *  \tparam Func       The function signature type for the function map
- *  \tparam MKP        The behavior policy for what to do in the case of a
- *                     missing key
- *  \tparam Hash       The hash function to use for the function map
- *  \tparam KeyEqual   The key equality function for the function map
- *  \tparam Allocator  The allocator to use for the function map
+ *  \par
+ *  Compound keys such as `std::tuple<std::string, int, Enum>` are supported
+ *  with the TupleHash and TupleEqual functors from tuple_key.h, which also
+ *  allow dispatching with a tuple of views without allocating a key.
+ *
+ *  \par
+ *  All state lives in a single global BasicRegistry, returned by Instance().
+ *  Use BasicRegistry directly for registries that should not be global.
+ *
+ *  \tparam Key          The identifier type for the function map
+ *  \tparam Func         The function signature type for the function map
+ *  \tparam MKP          The behavior policy for what to do in the case of a
+ *                       missing key
+ *  \tparam Hash         The hash function to use for the function map
+ *  \tparam KeyEqual     The key equality function for the function map
+ *  \tparam Allocator    The allocator to use for the function map
+ *  \tparam Concurrency  The locking policy, NoLockPolicy or SharedMutexPolicy
  */
 template <
     class Key, class Func, MissingKeyPolicy MKP = MissingKeyPolicy::exception,
     class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
-    class Allocator = std::allocator<std::pair<const Key, std::function<Func>>>>
+    class Allocator = std::allocator<
+        std::pair<const Key, typename detail::FunctionWrapper<Func>::type>>,
+    class Concurrency = NoLockPolicy>
 class Registry {
  public:
+  /// The registry type backing this global registry
+  using instance_t =
+      BasicRegistry<Key, Func, MKP, Hash, KeyEqual, Allocator, Concurrency>;
+
   /// Function object used for constructing subclasses
-  using func_t = std::function<Func>;
+  using func_t = typename instance_t::func_t;
+
+  using key_type = Key;
+
+  /// Batch of changes applied atomically by Commit()
+  using Transaction = typename instance_t::Transaction;
+
+  /// Return type of Dispatch()
+  using ret_t = typename instance_t::ret_t;
 
-  /// Constructor map
-  using map_t = std::unordered_map<Key, func_t, Hash, KeyEqual, Allocator>;
+  /// The map type of Registry 1.x; the functions are no longer stored in it
+  using map_t CPPREGPATTERN_DEPRECATED("use instance_t instead") =
+      std::unordered_map<Key, func_t, Hash, KeyEqual, Allocator>;
 
   Registry() = delete;
   Registry(const Registry&) = delete;
@@ -92,55 +1146,25 @@ class Registry {
   Registry& operator=(const Registry&) = delete;
   Registry& operator=(Registry&&) noexcept = delete;
 
-  template <class Registry>
-  struct Dispatcher {};
-
-  using dispatcher_t =
-      Dispatcher<Registry<Key, Func, MKP, Hash, KeyEqual, Allocator>>;
-  friend dispatcher_t;
-
-  /// Dispatcher specialization for the exception policy
-  template <class K, class F, class H, class KE, class A>
-  struct Dispatcher<Registry<K, F, MissingKeyPolicy::exception, H, KE, A>> {
-    using reg_t = Registry<K, F, MissingKeyPolicy::exception, H, KE, A>;
-    using ret_t = typename reg_t::func_t::result_type;
-
-    template <typename... Args>
-    static ret_t Dispatch(const K& key, Args&&... args) {
-      return reg_t::funcs().at(key)(std::forward<Args>(args)...);
-    }
-  };
+  /// The global registry instance
+  static instance_t& Instance() {
+    static instance_t instance;
+    return instance;
+  }
 
-  /// Dispatcher specialization for the default_construct policy
-  template <class K, class F, class H, class KE, class A>
-  struct Dispatcher<
-      Registry<K, F, MissingKeyPolicy::default_construct, H, KE, A>> {
-    using reg_t = Registry<K, F, MissingKeyPolicy::default_construct, H, KE, A>;
-    using ret_t = typename reg_t::func_t::result_type;
+  /// Kept for code written against Registry 1.x; calls Registry::Dispatch()
+  template <class R>
+  struct Dispatcher {
+    using ret_t = typename R::ret_t;
 
     template <typename... Args>
-    static ret_t Dispatch(const K& key, Args&&... args) {
-      auto it = reg_t::funcs().find(key);
-      if (it == reg_t::funcs().end()) return ret_t();
-      return it->second(std::forward<Args>(args)...);
+    CPPREGPATTERN_DEPRECATED("use Registry::Dispatch() instead")
+    static ret_t Dispatch(const typename R::key_type& key, Args&&... args) {
+      return R::Dispatch(key, std::forward<Args>(args)...);
     }
   };
 
-#if __cplusplus >= 201703L
-  /// Dispatcher specialization for the optional policy
-  template <class K, class F, class H, class KE, class A>
-  struct Dispatcher<Registry<K, F, MissingKeyPolicy::optional, H, KE, A>> {
-    using reg_t = Registry<K, F, MissingKeyPolicy::optional, H, KE, A>;
-    using ret_t = std::optional<typename reg_t::func_t::result_type>;
-
-    template <typename... Args>
-    static ret_t Dispatch(const K& key, Args&&... args) {
-      auto it = reg_t::funcs().find(key);
-      if (it == reg_t::funcs().end()) return std::nullopt;
-      return it->second(std::forward<Args>(args)...);
-    }
-  };
-#endif
+  using dispatcher_t = Dispatcher<Registry>;
 
   /** Calls one of the registered functions
    *
@@ -150,8 +1174,26 @@ class Registry {
    *  \return Result of the function
    */
   template <typename... Args>
-  static typename dispatcher_t::ret_t Dispatch(const Key& key, Args&&... args) {
-    return dispatcher_t::Dispatch(key, std::forward<Args>(args)...);
+  static ret_t Dispatch(const Key& key, Args&&... args) {
+    return Instance().Dispatch(key, std::forward<Args>(args)...);
+  }
+
+  /// Heterogeneous lookup variant of Dispatch(), see BasicRegistry
+  template <class LookupKey, typename... Args,
+            class H = Hash, class KE = KeyEqual,
+            class = typename detail::enable_heterogeneous<LookupKey, Key, H,
+                                                          KE>::type>
+  static ret_t Dispatch(const LookupKey& key, Args&&... args) {
+    return Instance().Dispatch(key, std::forward<Args>(args)...);
+  }
+
+  /// Test whether the given heterogeneous identifier is registered
+  template <class LookupKey,
+            class H = Hash, class KE = KeyEqual,
+            class = typename detail::enable_heterogeneous<LookupKey, Key, H,
+                                                          KE>::type>
+  static bool IsRegistered(const LookupKey& key) {
+    return Instance().IsRegistered(key);
   }
 
   /** Register a function with the registry
@@ -162,20 +1204,85 @@ class Registry {
    *  \return Whether registration is successful
    */
   static bool Register(const Key& key, const func_t& func) {
-    funcs()[key] = func;
-    return true;
+    return Instance().Register(key, func);
+  }
+
+  /// Register a function, taking ownership of it
+  static bool Register(const Key& key, func_t&& func) {
+    return Instance().Register(key, std::move(func));
+  }
+
+#if __cplusplus >= 201703L
+  /// Register a member function of `obj`, see BasicRegistry::Register()
+  template <auto Method, class C>
+  static bool Register(const Key& key, C& obj) {
+    return Instance().template Register<Method>(key, obj);
+  }
+#endif
+
+#if __cplusplus >= 201703L
+  /// Register a function created on first use, see
+  /// BasicRegistry::RegisterLazy()
+  template <class Init>
+  static bool RegisterLazy(const Key& key, Init init) {
+    return Instance().RegisterLazy(key, std::move(init));
+  }
+#endif
+
+  /// Register a function constructed in place, see BasicRegistry::Emplace()
+  template <class F>
+  static bool Emplace(const Key& key, F&& func) {
+    return Instance().Emplace(key, std::forward<F>(func));
   }
 
   /// Test whether the given identifier is registered
-  static bool IsRegistered(const Key& key) { return funcs().count(key) == 1u; }
+  static bool IsRegistered(const Key& key) {
+    return Instance().IsRegistered(key);
+  }
 
   /// Unregisters the given identifier
-  static void Unregister(const Key& key) { funcs().erase(key); }
+  static void Unregister(const Key& key) { Instance().Unregister(key); }
 
- private:
-  static map_t& funcs() {
-    static map_t func_map;
-    return func_map;
+  /// Makes the registry read-only, see BasicRegistry::Seal()
+  static void Seal() { Instance().Seal(); }
+
+  /// Applies a Transaction atomically, see BasicRegistry::Commit()
+  static std::uint64_t Commit(Transaction txn) {
+    return Instance().Commit(std::move(txn));
   }
+
+  /// Identifies the current state of the registry
+  static std::uint64_t Version() { return Instance().Version(); }
+
+  /// Frees replaced functions and versions, see BasicRegistry::Reclaim()
+  static void Reclaim() { Instance().Reclaim(); }
 };
 }
+
+/** Declares the Registry and BasicRegistry specializations with the given
+ *  template arguments as explicitly instantiated elsewhere, so that
+ *  translation units including this declaration (typically the header that
+ *  defines the registry's type alias) do not instantiate their members
+ *  again. Pair it with CPPREGPATTERN_INSTANTIATE_REGISTRY() in one source
+ *  file:
+ *
+ *  \code{.cpp}
+ *  // shapes.h
+ *  using ShapeRegistry = registry::Registry<std::string, Shape*()>;
+ *  CPPREGPATTERN_EXTERN_REGISTRY(std::string, Shape*());
+ *  // shapes.cpp
+ *  CPPREGPATTERN_INSTANTIATE_REGISTRY(std::string, Shape*());
+ *  \endcode
+ *
+ *  Member templates such as Dispatch() are still instantiated where used.
+ *  The stored function type must be copyable. Use at global scope.
+ */
+#define CPPREGPATTERN_EXTERN_REGISTRY(...)                        \
+  extern template class ::registry::BasicRegistry<__VA_ARGS__>; \
+  extern template class ::registry::Registry<__VA_ARGS__>
+
+/// Explicitly instantiates a registry declared with
+/// CPPREGPATTERN_EXTERN_REGISTRY()
+#define CPPREGPATTERN_INSTANTIATE_REGISTRY(...)            \
+  template class ::registry::BasicRegistry<__VA_ARGS__>; \
+  template class ::registry::Registry<__VA_ARGS__>
@@ -0,0 +1,118 @@
+/** Startup images of sealed registries
+ *
+ *  \file registry_image.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <dlfcn.h>
+
+#include "cppregpattern/shared_key_index.h"
+
+namespace registry {
+
+/** A precomputed table of function names and addresses, an alternative to
+ *  `dladdr`/`dlsym` for images of functions that are not exported
+ *  dynamically (e.g. in executables linked without `-rdynamic`)
+ */
+class SymbolTable {
+ public:
+  /// Adds `func` under `name`, which must be unique within the table
+  template <class R, class... Args>
+  void Add(const std::string& name, R (*func)(Args...)) {
+    void* address = reinterpret_cast<void*>(func);
+    by_name_[name] = address;
+    by_address_[address] = name;
+  }
+
+  /// Address of the function named `name`, or nullptr
+  void* Find(const std::string& name) const {
+    auto it = by_name_.find(name);
+    return it == by_name_.end() ? nullptr : it->second;
+  }
+
+  /// Name of the function at `address`, or an empty string
+  std::string NameOf(void* address) const {
+    auto it = by_address_.find(address);
+    return it == by_address_.end() ? std::string() : it->second;
+  }
+
+ private:
+  std::unordered_map<std::string, void*> by_name_;
+  std::unordered_map<void*, std::string> by_address_;
+};
+
+/** Writes an image of a sealed registry to `path`: its keys, slot order and
+ *  the symbol name of each function that is a plain function pointer. Names
+ *  come from `symbols` if given, from `dladdr` otherwise; functions without
+ *  a name (e.g. lambdas) are recorded by key only and must be bound again
+ *  on load.
+ *
+ *  \tparam Index  The SharedKeyIndex type the image will be loaded as
+ *
+ *  \throws std::runtime_error if the file cannot be written
+ */
+template <class Index, class Registry>
+void SaveImage(const Registry& registry, const std::string& path,
+               std::uint64_t fingerprint,
+               const SymbolTable* symbols = nullptr) {
+  using func_t = typename Index::func_t;
+  using pointer_t = typename Index::pointer_t;
+  Index::Export(registry, path, fingerprint,
+                [symbols](const func_t& func) -> std::string {
+                  const pointer_t* target = func.template target<pointer_t>();
+                  if (target == nullptr || *target == nullptr) return {};
+                  void* address = reinterpret_cast<void*>(*target);
+                  if (symbols != nullptr) return symbols->NameOf(address);
+                  Dl_info info;
+                  if (dladdr(address, &info) == 0 ||
+                      info.dli_sname == nullptr ||
+                      info.dli_saddr != address) {
+                    return {};
+                  }
+                  return info.dli_sname;
+                });
+}
+
+/** Maps an image written by SaveImage() and binds its named slots, through
+ *  `symbols` if given or `dlsym` otherwise, so that startup costs a page-in
+ *  instead of a rebuild of the registry
+ *
+ *  \par
+ *  Without `symbols`, every name in the image is passed to
+ *  `dlsym(RTLD_DEFAULT, ...)`, so whoever can write the image chooses which
+ *  function of the process each key dispatches to. Only load images from a
+ *  trusted path that the service cannot write to, such as the read-only
+ *  install directory; for images from anywhere else, pass a SymbolTable,
+ *  which limits the names to the functions added to it.
+ *
+ *  \return The loaded index, or nullptr if the image is missing, invalid,
+ *          has another fingerprint or names a function that cannot be
+ *          resolved; the caller then falls back to normal registration
+ */
+template <class Index>
+std::unique_ptr<Index> LoadImage(const std::string& path,
+                                 std::uint64_t fingerprint,
+                                 const SymbolTable* symbols = nullptr) {
+  std::unique_ptr<Index> index;
+  try {
+    index.reset(new Index(path, fingerprint));
+  } catch (const std::runtime_error&) {
+    return nullptr;
+  }
+  bool resolved = index->BindSymbols([symbols](const std::string& name) {
+    return symbols != nullptr ? symbols->Find(name)
+                              : dlsym(RTLD_DEFAULT, name.c_str());
+  });
+  if (!resolved) return nullptr;
+  return index;
+}
+
+}
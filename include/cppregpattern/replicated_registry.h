@@ -0,0 +1,301 @@
+/** Interface file for the ReplicatedRegistry class template
+ *
+ *  \file replicated_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/** Assignment of CPUs to replica groups for ReplicatedRegistry. Each group
+ *  gets its own copy of the registry's lookup table, built by a thread
+ *  running on the group's CPUs so that first-touch page placement puts the
+ *  copy in the group's local memory.
+ */
+class ReplicaLayout {
+ public:
+  /// One group per NUMA node (a single group if the topology is unknown)
+  static ReplicaLayout PerNumaNode() {
+    ReplicaLayout layout;
+#if defined(__linux__)
+    for (unsigned node = 0;; ++node) {
+      std::ifstream file("/sys/devices/system/node/node" +
+                         std::to_string(node) + "/cpulist");
+      if (!file) break;
+      std::string list;
+      std::getline(file, list);
+      layout.AddGroup(ParseCpuList(list));
+    }
+#endif
+    if (layout.groups() == 0) return Single();
+    return layout;
+  }
+
+  /// Groups of `cores_per_group` consecutive CPUs
+  static ReplicaLayout PerCoreGroup(unsigned cores_per_group) {
+    if (cores_per_group == 0) cores_per_group = 1;
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) cpus = 1;
+    ReplicaLayout layout;
+    for (unsigned first = 0; first < cpus; first += cores_per_group) {
+      std::vector<unsigned> group;
+      for (unsigned cpu = first; cpu < first + cores_per_group && cpu < cpus;
+           ++cpu) {
+        group.push_back(cpu);
+      }
+      layout.AddGroup(group);
+    }
+    return layout;
+  }
+
+  /// A single group covering every CPU, i.e. no replication
+  static ReplicaLayout Single() {
+    ReplicaLayout layout;
+    layout.AddGroup({});
+    return layout;
+  }
+
+  /// Number of replica groups
+  std::size_t groups() const { return cpus_.size(); }
+
+  /// CPUs in group `g` (empty for the catch-all group of Single())
+  const std::vector<unsigned>& cpus(std::size_t g) const { return cpus_[g]; }
+
+  /// Group serving the given CPU; CPUs outside the layout map to group 0
+  std::size_t GroupOf(unsigned cpu) const {
+    return cpu < group_of_cpu_.size() ? group_of_cpu_[cpu] : 0;
+  }
+
+  /// Group serving the calling thread's current CPU
+  std::size_t CurrentGroup() const { return GroupOf(CurrentCpu()); }
+
+ private:
+  void AddGroup(const std::vector<unsigned>& cpus) {
+    for (unsigned cpu : cpus) {
+      if (cpu >= group_of_cpu_.size()) group_of_cpu_.resize(cpu + 1, 0);
+      group_of_cpu_[cpu] = cpus_.size();
+    }
+    cpus_.push_back(cpus);
+  }
+
+  /// Parses the kernel's CPU list format, e.g. "0-3,8-11"
+  static std::vector<unsigned> ParseCpuList(const std::string& list) {
+    std::vector<unsigned> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+      if (range.empty()) continue;
+      std::size_t dash = range.find('-');
+      unsigned lo = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+      unsigned hi = dash == std::string::npos
+                        ? lo
+                        : static_cast<unsigned>(
+                              std::stoul(range.substr(dash + 1)));
+      for (unsigned cpu = lo; cpu <= hi; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+
+  /// The calling thread's CPU, re-read every 64 calls since threads rarely
+  /// migrate and the lookup is a system call on some platforms
+  static unsigned CurrentCpu() {
+#if defined(__linux__)
+    thread_local unsigned cpu = 0;
+    thread_local unsigned countdown = 0;
+    if (countdown-- == 0) {
+      int current = sched_getcpu();
+      cpu = current < 0 ? 0 : static_cast<unsigned>(current);
+      countdown = 63;
+    }
+    return cpu;
+#else
+    return 0;
+#endif
+  }
+
+  std::vector<std::vector<unsigned>> cpus_;
+  std::vector<std::size_t> group_of_cpu_;
+};
+
+/** A read-mostly registry that keeps one copy of its lookup table per CPU
+ *  group (see ReplicaLayout), so that Dispatch() on a multi-socket host only
+ *  reads memory local to the calling thread's node and no cache line of the
+ *  table is shared across sockets.
+ *
+ *  \par
+ *  The registry is changed through Commit() only: the Transaction is
+ *  committed to the sealed BasicRegistry owned by this object, then every
+ *  replica is rebuilt by a thread pinned to its group's CPUs and the new set
+ *  of replicas is published atomically, as with BasicRegistry::Commit().
+ *  Replicas map keys to the functions stored in the owned registry; only the
+ *  lookup tables are replicated. Superseded replicas are freed by Reclaim().
+ *
+ *  \code{.cpp}
+ *  using Handlers = BasicRegistry<std::string, Response(const Request&)>;
+ *  ReplicatedRegistry<Handlers> handlers(ReplicaLayout::PerNumaNode());
+ *  Handlers::Transaction txn;
+ *  txn.Register("echo", Echo).Register("stat", Stat);
+ *  handlers.Commit(std::move(txn));
+ *  Response r = handlers.Dispatch("echo", request);
+ *  \endcode
+ *
+ *  \tparam Base  The BasicRegistry type holding the registered functions
+ */
+template <class Base>
+class ReplicatedRegistry {
+ public:
+  using key_type = typename Base::key_type;
+  using func_t = typename Base::func_t;
+  using missing_key_t = typename Base::missing_key_t;
+  using ret_t = typename Base::ret_t;
+  using Transaction = typename Base::Transaction;
+
+  explicit ReplicatedRegistry(
+      ReplicaLayout layout = ReplicaLayout::PerNumaNode())
+      : layout_(std::move(layout)) {
+    base_.Seal();
+    Publish();
+  }
+
+  ReplicatedRegistry(const ReplicatedRegistry&) = delete;
+  ReplicatedRegistry& operator=(const ReplicatedRegistry&) = delete;
+
+  /** Calls one of the registered functions, looked up in the replica of the
+   *  calling thread's CPU group
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const key_type& key, Args&&... args) const {
+    CPPREGPATTERN_RT_SCOPE("registry::ReplicatedRegistry::Dispatch");
+    const func_t* func = Find(key);
+    if (func == nullptr) {
+      return missing_key_t::Handle(
+          "registry::ReplicatedRegistry::Dispatch: unknown key");
+    }
+    return (*func)(std::forward<Args>(args)...);
+  }
+
+  /// Returns the function registered under `key`, or nullptr
+  const func_t* Find(const key_type& key) const {
+    const replicas_t* replicas = current_.load(std::memory_order_acquire);
+    const table_t& table = *(*replicas)[layout_.CurrentGroup()];
+    auto it = table.find(key);
+    return it == table.end() ? nullptr : it->second;
+  }
+
+  /// Test whether the given identifier is registered
+  bool IsRegistered(const key_type& key) const {
+    return Find(key) != nullptr;
+  }
+
+  /** Applies all operations of `txn` at once and refreshes every replica
+   *
+   *  \throws std::out_of_range as BasicRegistry::Commit(), in which case
+   *          nothing is applied
+   *
+   *  \return The new Version()
+   */
+  std::uint64_t Commit(Transaction txn) {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    std::uint64_t version = base_.Commit(std::move(txn));
+    Publish();
+    return version;
+  }
+
+  /// Identifies the current state of the registry, see BasicRegistry
+  std::uint64_t Version() const { return base_.Version(); }
+
+  /// Frees superseded replicas and functions, see BasicRegistry::Reclaim()
+  void Reclaim() {
+    std::lock_guard<std::mutex> writer(writer_mutex_);
+    base_.Reclaim();
+    const replicas_t* current = current_.load(std::memory_order_relaxed);
+    for (auto& replicas : history_) {
+      if (replicas.get() == current) {
+        std::unique_ptr<replicas_t> keep = std::move(replicas);
+        history_.clear();
+        history_.push_back(std::move(keep));
+        break;
+      }
+    }
+  }
+
+  /// The sealed registry holding the functions
+  const Base& base() const { return base_; }
+
+  /// The CPU group layout of the replicas
+  const ReplicaLayout& layout() const { return layout_; }
+
+ private:
+  using table_t =
+      std::unordered_map<key_type, const func_t*, typename Base::hasher,
+                         typename Base::key_equal>;
+  using replicas_t = std::vector<std::unique_ptr<table_t>>;
+
+  /// Builds replica `g` on a thread bound to the group's CPUs
+  void Build(std::size_t g, std::unique_ptr<table_t>& out) const {
+#if defined(__linux__)
+    const std::vector<unsigned>& cpus = layout_.cpus(g);
+    if (!cpus.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (unsigned cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+      }
+      // Best effort: without the binding the replica is still correct, only
+      // possibly placed on a remote node.
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+    std::unique_ptr<table_t> table(new table_t(base_.size()));
+    base_.ForEach([&table](const key_type& key, const func_t* func) {
+      table->emplace(key, func);
+    });
+    out = std::move(table);
+  }
+
+  void Publish() {
+    std::unique_ptr<replicas_t> replicas(new replicas_t(layout_.groups()));
+    std::vector<std::thread> builders;
+    for (std::size_t g = 0; g < replicas->size(); ++g) {
+      builders.emplace_back(&ReplicatedRegistry::Build, this, g,
+                            std::ref((*replicas)[g]));
+    }
+    for (std::thread& builder : builders) builder.join();
+    history_.push_back(std::move(replicas));
+    current_.store(history_.back().get(), std::memory_order_release);
+  }
+
+  Base base_;
+  ReplicaLayout layout_;
+  std::atomic<const replicas_t*> current_{nullptr};
+  std::vector<std::unique_ptr<replicas_t>> history_;  // Current and retired
+  std::mutex writer_mutex_;
+};
+
+}
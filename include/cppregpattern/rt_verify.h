@@ -0,0 +1,251 @@
+/** Real-time verification of the dispatch path
+ *
+ *  \file rt_verify.h
+ *  \date 18 Oct 2026
+ *
+ *  Building with `CPPREGPATTERN_RT_VERIFY` defined makes every Dispatch() of
+ *  the library run inside an rt::Scope. While a scope is active on a thread,
+ *  heap allocations (reported by the operator new replacement that
+ *  CPPREGPATTERN_RT_VERIFY_OPERATOR_NEW() defines), lock acquisitions made
+ *  through the library's concurrency policies and exceptions leaving the
+ *  dispatched function are violations. They are passed to the handler set
+ *  with rt::SetViolationHandler(), which by default prints them and aborts,
+ *  or counted by rt::Check() in tests.
+ *
+ *  \code{.cpp}
+ *  // In one translation unit of the test binary:
+ *  CPPREGPATTERN_RT_VERIFY_OPERATOR_NEW()
+ *
+ *  rt::Report report = rt::Check([] { Handlers::Dispatch("pid", 0.001); });
+ *  assert(report.clean());
+ *  \endcode
+ *
+ *  Without `CPPREGPATTERN_RT_VERIFY` the hooks compile to nothing. The
+ *  verification mode itself needs C++17.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+namespace registry {
+namespace rt {
+
+/// Kinds of operations not allowed on a real-time dispatch path
+enum class Violation { allocation, lock, exception };
+
+/// Violations counted by Check()
+struct Report {
+  std::size_t allocations = 0;
+  std::size_t locks = 0;
+  std::size_t exceptions = 0;
+
+  bool clean() const { return allocations + locks + exceptions == 0; }
+};
+
+/// Called with the kind of violation and the name of the active scope
+using ViolationHandler = void (*)(Violation, const char*);
+
+inline const char* ToString(Violation violation) {
+  switch (violation) {
+    case Violation::allocation:
+      return "allocation";
+    case Violation::lock:
+      return "lock";
+    case Violation::exception:
+      return "exception";
+  }
+  return "unknown";
+}
+
+/// The default handler: reports the violation on stderr and aborts
+inline void AbortOnViolation(Violation violation, const char* where) {
+  std::fprintf(stderr, "registry: real-time violation (%s) in %s\n",
+               ToString(violation), where);
+  std::abort();
+}
+
+namespace detail {
+
+struct ThreadState {
+  unsigned depth = 0;
+  int reported = 0;  // Uncaught exceptions already reported by a Scope
+  bool notifying = false;
+  const char* where = "";
+  Report* recording = nullptr;
+};
+
+inline ThreadState& State() {
+  thread_local ThreadState state;
+  return state;
+}
+
+inline ViolationHandler& Handler() {
+  static ViolationHandler handler = &AbortOnViolation;
+  return handler;
+}
+
+inline void Notify(Violation violation) {
+  ThreadState& state = State();
+  if (state.depth == 0 || state.notifying) return;
+  if (state.recording != nullptr) {
+    switch (violation) {
+      case Violation::allocation:
+        ++state.recording->allocations;
+        break;
+      case Violation::lock:
+        ++state.recording->locks;
+        break;
+      case Violation::exception:
+        ++state.recording->exceptions;
+        break;
+    }
+    return;
+  }
+  // The handler may itself allocate or throw
+  state.notifying = true;
+  Handler()(violation, state.where);
+  state.notifying = false;
+}
+
+}
+
+/// Replaces the violation handler (not thread-safe; set it at startup)
+inline void SetViolationHandler(ViolationHandler handler) {
+  detail::Handler() = handler;
+}
+
+#ifdef CPPREGPATTERN_RT_VERIFY
+inline void OnAllocation() { detail::Notify(Violation::allocation); }
+inline void OnLock() { detail::Notify(Violation::lock); }
+
+/// Marks the calling thread as being on a real-time path while alive
+class Scope {
+ public:
+  explicit Scope(const char* where)
+      : previous_(detail::State().where),
+        exceptions_(std::uncaught_exceptions()) {
+    detail::ThreadState& state = detail::State();
+    ++state.depth;
+    state.where = where;
+    if (state.reported > exceptions_) state.reported = exceptions_;
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  ~Scope() {
+    // An exception is reported by the innermost scope it leaves only
+    detail::ThreadState& state = detail::State();
+    int uncaught = std::uncaught_exceptions();
+    if (uncaught > exceptions_ && uncaught > state.reported) {
+      detail::Notify(Violation::exception);
+      state.reported = uncaught;
+    }
+    if (--state.depth == 0) state.reported = 0;
+    state.where = previous_;
+  }
+
+ private:
+  const char* previous_;
+  int exceptions_;
+};
+
+#define CPPREGPATTERN_RT_SCOPE(where) \
+  ::registry::rt::Scope cppregpattern_rt_scope_(where)
+#else
+inline void OnAllocation() {}
+inline void OnLock() {}
+
+class Scope {
+ public:
+  explicit Scope(const char*) {}
+};
+
+#define CPPREGPATTERN_RT_SCOPE(where) static_cast<void>(0)
+#endif
+
+/** Runs `f` and counts the violations of the dispatches it makes instead
+ *  of passing them to the handler. Work done by `f` itself, such as building
+ *  arguments, is not checked; exceptions escaping `f` are swallowed.
+ *  Without `CPPREGPATTERN_RT_VERIFY` the report is always clean.
+ */
+template <class F>
+Report Check(F&& f) {
+  Report report;
+  detail::ThreadState& state = detail::State();
+  Report* previous = state.recording;
+  state.recording = &report;
+  try {
+    f();
+  } catch (...) {
+  }
+  state.recording = previous;
+  return report;
+}
+
+}
+
+namespace detail {
+
+/// A lock of type `Lock` that reports its acquisition to rt::OnLock()
+template <class Lock>
+class CheckedLock : public Lock {
+ public:
+  template <class Mutex>
+  explicit CheckedLock(Mutex& mutex) : Lock((rt::OnLock(), mutex)) {}
+};
+
+}
+
+}
+
+#ifdef CPPREGPATTERN_RT_VERIFY
+#include <new>
+
+/** Defines replacements of the global allocation functions that report to
+ *  rt::OnAllocation(). Use it in exactly one translation unit.
+ */
+#define CPPREGPATTERN_RT_VERIFY_OPERATOR_NEW()                              \
+  void* operator new(std::size_t size) {                                    \
+    ::registry::rt::OnAllocation();                                         \
+    if (void* p = std::malloc(size ? size : 1)) return p;                   \
+    throw std::bad_alloc();                                                 \
+  }                                                                         \
+  void* operator new[](std::size_t size) { return ::operator new(size); }   \
+  void* operator new(std::size_t size, const std::nothrow_t&) noexcept {    \
+    ::registry::rt::OnAllocation();                                         \
+    return std::malloc(size ? size : 1);                                    \
+  }                                                                         \
+  void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {  \
+    return ::operator new(size, std::nothrow);                              \
+  }                                                                         \
+  void* operator new(std::size_t size, std::align_val_t align) {           \
+    ::registry::rt::OnAllocation();                                         \
+    std::size_t a = static_cast<std::size_t>(align);                        \
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;  \
+    throw std::bad_alloc();                                                 \
+  }                                                                         \
+  void* operator new[](std::size_t size, std::align_val_t align) {         \
+    return ::operator new(size, align);                                     \
+  }                                                                         \
+  void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }\
+  void operator delete[](void* p, std::align_val_t) noexcept {             \
+    std::free(p);                                                           \
+  }                                                                         \
+  void operator delete(void* p, std::size_t, std::align_val_t) noexcept {   \
+    std::free(p);                                                           \
+  }                                                                         \
+  void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { \
+    std::free(p);                                                           \
+  }                                                                         \
+  void operator delete(void* p) noexcept { std::free(p); }                  \
+  void operator delete[](void* p) noexcept { std::free(p); }                \
+  void operator delete(void* p, std::size_t) noexcept { std::free(p); }     \
+  void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#else
+#define CPPREGPATTERN_RT_VERIFY_OPERATOR_NEW()
+#endif
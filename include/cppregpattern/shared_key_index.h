@@ -0,0 +1,396 @@
+/** Interface file for the SharedKeyIndex class template
+ *
+ *  \file shared_key_index.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cppregpattern/key_codec.h"
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+namespace detail {
+
+/// Layout of an exported index. All positions are byte offsets from the
+/// start of the segment, so it can be mapped at any address.
+struct SharedIndexHeader {
+  char magic[8];
+  std::uint32_t format;
+  std::uint32_t reserved;
+  std::uint64_t fingerprint;
+  std::uint64_t key_count;
+  std::uint64_t capacity;     // Slots in the hash table, a power of two
+  std::uint64_t slots_offset;
+  std::uint64_t symbols_offset;  // SharedIndexSymbol per slot id
+  std::uint64_t blob_offset;     // Encoded keys and symbol names
+  std::uint64_t total_size;
+};
+
+struct SharedIndexSlot {
+  std::uint64_t hash;
+  std::uint64_t key_offset;  // Relative to blob_offset
+  std::uint32_t key_size;
+  std::uint32_t slot_id;     // Dense id in [0, key_count), or kEmptySlot
+};
+
+/// Name of the function exported for a slot, empty if it has none
+struct SharedIndexSymbol {
+  std::uint64_t name_offset;  // Relative to blob_offset
+  std::uint64_t name_size;
+};
+
+constexpr char kSharedIndexMagic[8] = {'C', 'R', 'P', 'K', 'I', 'D', 'X', 0};
+constexpr std::uint32_t kSharedIndexFormat = 2;
+constexpr std::uint32_t kEmptySlot = 0xffffffffu;
+
+}
+
+/** A registry whose key table lives in a file or POSIX shared-memory
+ *  segment (e.g. under /dev/shm) shared by several processes. One process
+ *  exports the keys of a sealed registry with Export(); every other process
+ *  maps the segment read-only and only binds each slot id to its local
+ *  function, instead of building its own copy of the table.
+ *
+ *  \par
+ *  Keys are stored in their KeyCodec encoding and hashed with a stable hash,
+ *  and the layout uses offsets only, so the segment is position independent.
+ *  Each segment records a fingerprint chosen by the exporter (typically a
+ *  hash of the plugin set or a build id); attaching with a different
+ *  fingerprint, or to a segment of another format, is rejected. A segment
+ *  can also name the function of each slot (see registry_image.h), so that
+ *  BindSymbols() can bind slots without a local registry.
+ *
+ *  \code{.cpp}
+ *  // Parent, after all plugins registered:
+ *  using Index = SharedKeyIndex<std::string, Result(const Input&)>;
+ *  Index::Export(Handlers::Instance(), "/dev/shm/handlers", kBuildId);
+ *  // Each worker:
+ *  Index index("/dev/shm/handlers", kBuildId);
+ *  index.Bind(LocalHandlers::Instance());
+ *  Result r = index.Dispatch("parse", input);
+ *  \endcode
+ *
+ *  \tparam Key        The identifier type, with a KeyCodec specialisation
+ *  \tparam Func       The function signature of the registered functions
+ *  \tparam MKP        The behavior policy for what to do in the case of a
+ *                     missing or unbound key
+ */
+template <class Key, class Func,
+          MissingKeyPolicy MKP = MissingKeyPolicy::exception>
+class SharedKeyIndex {
+ public:
+  using func_t = std::function<Func>;
+  using pointer_t = Func*;
+  using missing_key_t =
+      detail::MissingKey<MKP, typename func_t::result_type>;
+  using ret_t = typename missing_key_t::ret_t;
+  using codec_t = KeyCodec<Key>;
+
+  /** Writes the keys of `registry` to a new segment at `path`, replacing
+   *  any previous one atomically
+   *
+   *  \param registry     A registry providing ForEach() and size(), such as
+   *                      a sealed BasicRegistry
+   *  \param path         File to write, e.g. "/dev/shm/handlers"
+   *  \param fingerprint  Value attaching processes must present
+   *
+   *  \throws std::runtime_error if the file cannot be written
+   */
+  template <class Registry>
+  static void Export(const Registry& registry, const std::string& path,
+                     std::uint64_t fingerprint) {
+    Export(registry, path, fingerprint,
+           [](const func_t&) { return std::string(); });
+  }
+
+  /** Like Export(), and also records `namer(func)` as the symbol name of
+   *  each key's function; an empty name records none
+   */
+  template <class Registry, class Namer>
+  static void Export(const Registry& registry, const std::string& path,
+                     std::uint64_t fingerprint, Namer namer) {
+    using detail::SharedIndexHeader;
+    using detail::SharedIndexSlot;
+    using detail::SharedIndexSymbol;
+    std::uint64_t capacity = 8;
+    while (capacity < 2 * registry.size()) capacity *= 2;
+
+    std::vector<SharedIndexSlot> slots(
+        capacity, SharedIndexSlot{0, 0, 0, detail::kEmptySlot});
+    std::vector<SharedIndexSymbol> symbols;
+    std::string blob;
+    std::uint32_t next_id = 0;
+    registry.ForEach([&](const Key& key, const func_t* func) {
+      KeyBytes bytes = codec_t::Encode(key);
+      std::uint64_t hash = detail::StableHash(bytes);
+      std::uint64_t mask = capacity - 1;
+      std::uint64_t i = hash & mask;
+      while (slots[i].slot_id != detail::kEmptySlot) i = (i + 1) & mask;
+      slots[i] = SharedIndexSlot{hash, blob.size(),
+                                 static_cast<std::uint32_t>(bytes.size),
+                                 next_id++};
+      blob.append(static_cast<const char*>(bytes.data), bytes.size);
+      std::string name = namer(*func);
+      symbols.push_back(SharedIndexSymbol{blob.size(), name.size()});
+      blob += name;
+    });
+
+    SharedIndexHeader header;
+    std::memcpy(header.magic, detail::kSharedIndexMagic, sizeof(header.magic));
+    header.format = detail::kSharedIndexFormat;
+    header.reserved = 0;
+    header.fingerprint = fingerprint;
+    header.key_count = next_id;
+    header.capacity = capacity;
+    header.slots_offset = sizeof(SharedIndexHeader);
+    header.symbols_offset =
+        header.slots_offset + capacity * sizeof(SharedIndexSlot);
+    header.blob_offset =
+        header.symbols_offset + symbols.size() * sizeof(SharedIndexSymbol);
+    header.total_size = header.blob_offset + blob.size();
+
+    std::string tmp = path + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char*>(slots.data()),
+                static_cast<std::streamsize>(slots.size() *
+                                             sizeof(SharedIndexSlot)));
+      out.write(reinterpret_cast<const char*>(symbols.data()),
+                static_cast<std::streamsize>(symbols.size() *
+                                             sizeof(SharedIndexSymbol)));
+      out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+      if (!out) {
+        throw std::runtime_error("registry::SharedKeyIndex::Export: cannot "
+                                 "write " + tmp);
+      }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      throw std::runtime_error("registry::SharedKeyIndex::Export: cannot "
+                               "replace " + path);
+    }
+  }
+
+  /** Maps the segment at `path` read-only
+   *
+   *  \throws std::runtime_error if the segment cannot be mapped, is not a
+   *          valid index, or was exported with another fingerprint
+   */
+  SharedKeyIndex(const std::string& path, std::uint64_t fingerprint) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) Fail("cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+      close(fd);
+      Fail("truncated segment " + path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) Fail("cannot map " + path);
+    base_ = static_cast<const unsigned char*>(p);
+
+    const Header& h = header();
+    const char* error = nullptr;
+    if (std::memcmp(h.magic, detail::kSharedIndexMagic, sizeof(h.magic)) != 0) {
+      error = "not a key index: ";
+    } else if (h.format != detail::kSharedIndexFormat) {
+      error = "unsupported format: ";
+    } else if (h.fingerprint != fingerprint) {
+      error = "stale segment: ";
+    } else if (!Valid(h, base_, size_)) {
+      error = "corrupt segment: ";
+    }
+    if (error != nullptr) {
+      munmap(const_cast<unsigned char*>(base_), size_);
+      Fail(error + path);
+    }
+    funcs_.resize(h.key_count);
+  }
+
+  SharedKeyIndex(const SharedKeyIndex&) = delete;
+  SharedKeyIndex& operator=(const SharedKeyIndex&) = delete;
+
+  ~SharedKeyIndex() { munmap(const_cast<unsigned char*>(base_), size_); }
+
+  /// Number of keys in the segment
+  std::size_t size() const { return funcs_.size(); }
+
+  /// Returns the slot id of `key`, or -1 if the segment does not contain it
+  std::int64_t SlotOf(const Key& key) const {
+    KeyBytes bytes = codec_t::Encode(key);
+    std::uint64_t hash = detail::StableHash(bytes);
+    const Header& h = header();
+    const Slot* slots = reinterpret_cast<const Slot*>(base_ + h.slots_offset);
+    const unsigned char* blob = base_ + h.blob_offset;
+    for (std::uint64_t i = hash & (h.capacity - 1);;
+         i = (i + 1) & (h.capacity - 1)) {
+      const Slot& slot = slots[i];
+      if (slot.slot_id == detail::kEmptySlot) return -1;
+      if (slot.hash == hash && slot.key_size == bytes.size &&
+          std::memcmp(blob + slot.key_offset, bytes.data, bytes.size) == 0) {
+        return slot.slot_id;
+      }
+    }
+  }
+
+  /** Binds the local function for `key`
+   *
+   *  \return Whether the segment contains `key`
+   */
+  bool Bind(const Key& key, const func_t& func) {
+    std::int64_t id = SlotOf(key);
+    if (id < 0) return false;
+    funcs_[static_cast<std::size_t>(id)] = func;
+    return true;
+  }
+
+  /** Binds every key of a local registry providing ForEach(), such as a
+   *  BasicRegistry, to its function there
+   *
+   *  \return Number of keys bound
+   */
+  template <class Registry>
+  std::size_t Bind(const Registry& registry) {
+    std::size_t bound = 0;
+    registry.ForEach([&](const Key& key, const func_t* func) {
+      if (Bind(key, *func)) ++bound;
+    });
+    return bound;
+  }
+
+  /// Symbol name recorded for slot `id`, empty if none
+  std::string SymbolName(std::size_t id) const {
+    const Symbol& symbol = reinterpret_cast<const Symbol*>(
+        base_ + header().symbols_offset)[id];
+    return std::string(reinterpret_cast<const char*>(
+                           base_ + header().blob_offset + symbol.name_offset),
+                       symbol.name_size);
+  }
+
+  /** Binds every slot that has a symbol name to `resolve(name)`, which
+   *  returns the address of a function of type `Func` or nullptr
+   *
+   *  \return Whether every named slot was resolved
+   */
+  template <class Resolver>
+  bool BindSymbols(Resolver resolve) {
+    bool all = true;
+    for (std::size_t id = 0; id < funcs_.size(); ++id) {
+      std::string name = SymbolName(id);
+      if (name.empty()) continue;
+      void* address = resolve(name);
+      if (address == nullptr) {
+        all = false;
+      } else {
+        funcs_[id] = reinterpret_cast<pointer_t>(address);
+      }
+    }
+    return all;
+  }
+
+  /** Calls the function bound to `key`
+   *
+   *  \param key   The identifier
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  ret_t Dispatch(const Key& key, Args&&... args) const {
+    CPPREGPATTERN_RT_SCOPE("registry::SharedKeyIndex::Dispatch");
+    std::int64_t id = SlotOf(key);
+    if (id < 0 || !funcs_[static_cast<std::size_t>(id)]) {
+      return missing_key_t::Handle(
+          "registry::SharedKeyIndex::Dispatch: unknown key");
+    }
+    return funcs_[static_cast<std::size_t>(id)](std::forward<Args>(args)...);
+  }
+
+  /// Test whether `key` is in the segment and bound in this process
+  bool IsRegistered(const Key& key) const {
+    std::int64_t id = SlotOf(key);
+    return id >= 0 && static_cast<bool>(funcs_[static_cast<std::size_t>(id)]);
+  }
+
+ private:
+  using Header = detail::SharedIndexHeader;
+  using Slot = detail::SharedIndexSlot;
+  using Symbol = detail::SharedIndexSymbol;
+
+  /** Checks that the header and tables of a segment of `size` bytes at
+   *  `base` stay within the segment, since the file is not trusted. Bounds
+   *  are compared by subtraction and division so they cannot wrap around.
+   */
+  static bool Valid(const Header& h, const unsigned char* base,
+                    std::size_t size) {
+    if (h.total_size != size || h.capacity == 0 ||
+        (h.capacity & (h.capacity - 1)) != 0 || h.key_count >= h.capacity ||
+        h.slots_offset < sizeof(Header) ||
+        h.slots_offset % alignof(Slot) != 0 ||
+        h.symbols_offset % alignof(Symbol) != 0 ||
+        h.symbols_offset < h.slots_offset ||
+        (h.symbols_offset - h.slots_offset) / sizeof(Slot) < h.capacity ||
+        h.blob_offset < h.symbols_offset ||
+        (h.blob_offset - h.symbols_offset) / sizeof(Symbol) < h.key_count ||
+        h.blob_offset > size) {
+      return false;
+    }
+    const std::uint64_t blob_size = size - h.blob_offset;
+    const Slot* slots = reinterpret_cast<const Slot*>(base + h.slots_offset);
+    bool has_empty = false;  // Otherwise a probe for a missing key never ends
+    for (std::uint64_t i = 0; i < h.capacity; ++i) {
+      const Slot& slot = slots[i];
+      if (slot.slot_id == detail::kEmptySlot) {
+        has_empty = true;
+      } else if (slot.slot_id >= h.key_count || slot.key_offset > blob_size ||
+                 slot.key_size > blob_size - slot.key_offset) {
+        return false;
+      }
+    }
+    const Symbol* symbols =
+        reinterpret_cast<const Symbol*>(base + h.symbols_offset);
+    for (std::uint64_t i = 0; i < h.key_count; ++i) {
+      if (symbols[i].name_offset > blob_size ||
+          symbols[i].name_size > blob_size - symbols[i].name_offset) {
+        return false;
+      }
+    }
+    return has_empty;
+  }
+
+  static void Fail(const std::string& what) {
+    throw std::runtime_error("registry::SharedKeyIndex: " + what);
+  }
+
+  const Header& header() const {
+    return *reinterpret_cast<const Header*>(base_);
+  }
+
+  const unsigned char* base_ = nullptr;
+  std::size_t size_ = 0;
+  std::vector<func_t> funcs_;  // Indexed by slot id
+};
+
+}
@@ -0,0 +1,409 @@
+/** Interface file for the TaggedRegistry class template
+ *
+ *  \file tagged_registry.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+/// Tags and numeric attributes describing a registered function
+struct Metadata {
+  std::vector<std::string> tags{};
+  std::vector<std::pair<std::string, double>> attributes{};
+};
+
+/** A capability query for TaggedRegistry::Select(). An entry matches when it
+ *  has every tag in `all`, at least one tag in `any` (if `any` is not empty),
+ *  none of the tags in `none`, and every attribute named in `ranges` within
+ *  its inclusive `[min, max]` bounds.
+ */
+struct TagQuery {
+  struct Range {
+    std::string attribute;
+    double min = -std::numeric_limits<double>::infinity();
+    double max = std::numeric_limits<double>::infinity();
+  };
+
+  std::vector<std::string> all{};
+  std::vector<std::string> any{};
+  std::vector<std::string> none{};
+  std::vector<Range> ranges{};
+};
+
+/** A self-registering map of functions whose registrations carry Metadata,
+ *  allowing to select all keys with a given set of capabilities without
+ *  calling into each registered function.
+ *
+ *  \par
+ *  Entries are kept in a dense array, and every tag owns a bitmap over that
+ *  array, so Select() reduces to word-wise AND / OR / AND-NOT over the
+ *  bitmaps of the queried tags followed by a scan of the set bits. Numeric
+ *  attributes are stored column-wise. Results are cached per query until the
+ *  next Register() or Unregister(); the cache holds up to 1024 queries and
+ *  is emptied when full, so queries built from runtime data do not grow it
+ *  without bound. The same threading rules as Registry
+ *  apply; Select() may be called concurrently with Dispatch() and itself.
+ *
+ *  \code{.cpp}
+ *  using CodecRegistry = TaggedRegistry<std::string, std::unique_ptr<Codec>()>;
+ *  CodecRegistry::Register("flac", MakeFlac, {{"streaming", "lossless"}});
+ *  auto keys = CodecRegistry::Select({"streaming", "lossless"});
+ *  \endcode
+ *
+ *  \tparam Key        The identifier type for the function map
+ *  \tparam Func       The function signature type for the function map
+ *  \tparam MKP        The behavior policy for what to do in the case of a
+ *                     missing key
+ *  \tparam Hash       The hash function to use for the function map
+ *  \tparam KeyEqual   The key equality function for the function map
+ */
+template <class Key, class Func,
+          MissingKeyPolicy MKP = MissingKeyPolicy::exception,
+          class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class TaggedRegistry {
+ public:
+  /// Function object stored for each key
+  using func_t = std::function<Func>;
+
+  /// Result of Select(), shared with the query cache
+  using selection_t = std::shared_ptr<const std::vector<Key>>;
+
+  using missing_key_t =
+      detail::MissingKey<MKP, typename func_t::result_type>;
+
+  TaggedRegistry() = delete;
+  TaggedRegistry(const TaggedRegistry&) = delete;
+  TaggedRegistry(TaggedRegistry&&) noexcept = delete;
+  TaggedRegistry& operator=(const TaggedRegistry&) = delete;
+  TaggedRegistry& operator=(TaggedRegistry&&) noexcept = delete;
+
+  /** Calls one of the registered functions
+   *
+   *  \param key   The identifier passed to Register()
+   *  \param args  Arguments to forward to the function
+   *
+   *  \return Result of the function
+   */
+  template <typename... Args>
+  static typename missing_key_t::ret_t Dispatch(const Key& key,
+                                                Args&&... args) {
+    CPPREGPATTERN_RT_SCOPE("registry::TaggedRegistry::Dispatch");
+    const State& s = state();
+    auto it = s.index.find(key);
+    if (it == s.index.end()) {
+      return missing_key_t::Handle(
+          "registry::TaggedRegistry::Dispatch: unknown key");
+    }
+    return s.funcs[it->second](std::forward<Args>(args)...);
+  }
+
+  /** Register a function with the registry
+   *
+   *  \param key       The identifier under which to register this function
+   *  \param func      Function to register
+   *  \param metadata  Tags and attributes of the function. Replaces the
+   *                   metadata of a previous registration under `key`.
+   *
+   *  \return Whether registration is successful
+   */
+  static bool Register(const Key& key, const func_t& func,
+                       const Metadata& metadata = Metadata()) {
+    State& s = state();
+    auto it = s.index.find(key);
+    std::size_t i;
+    if (it != s.index.end()) {
+      i = it->second;
+      s.funcs[i] = func;
+      for (auto& bitmap : s.bitmaps) Clear(bitmap, i);
+      for (auto& column : s.columns) column[i] = kMissing;
+    } else {
+      i = s.keys.size();
+      s.index.emplace(key, i);
+      s.keys.push_back(key);
+      s.funcs.push_back(func);
+      for (auto& bitmap : s.bitmaps) bitmap.resize(Words(i + 1));
+      for (auto& column : s.columns) column.push_back(kMissing);
+    }
+
+    for (const std::string& tag : metadata.tags) {
+      Set(s.bitmaps[TagId(s, tag)], i);
+    }
+    for (const auto& attribute : metadata.attributes) {
+      s.columns[AttributeId(s, attribute.first)][i] = attribute.second;
+    }
+    ClearCache(s);
+    return true;
+  }
+
+  /// Test whether the given identifier is registered
+  static bool IsRegistered(const Key& key) {
+    return state().index.count(key) == 1u;
+  }
+
+  /// Unregisters the given identifier
+  static void Unregister(const Key& key) {
+    State& s = state();
+    auto it = s.index.find(key);
+    if (it == s.index.end()) return;
+
+    // Move the last entry into the freed slot to keep the arrays dense.
+    std::size_t i = it->second;
+    std::size_t last = s.keys.size() - 1;
+    s.index.erase(it);
+    if (i != last) {
+      s.keys[i] = std::move(s.keys[last]);
+      s.funcs[i] = std::move(s.funcs[last]);
+      s.index[s.keys[i]] = i;
+      for (auto& bitmap : s.bitmaps) {
+        if (Test(bitmap, last)) {
+          Set(bitmap, i);
+        } else {
+          Clear(bitmap, i);
+        }
+      }
+      for (auto& column : s.columns) column[i] = column[last];
+    }
+    s.keys.pop_back();
+    s.funcs.pop_back();
+    for (auto& bitmap : s.bitmaps) {
+      Clear(bitmap, last);
+      bitmap.resize(Words(last));
+    }
+    for (auto& column : s.columns) column.pop_back();
+    ClearCache(s);
+  }
+
+  /// Test whether the function registered under `key` has the given tag
+  static bool HasTag(const Key& key, const std::string& tag) {
+    const State& s = state();
+    auto entry = s.index.find(key);
+    auto id = s.tag_ids.find(tag);
+    if (entry == s.index.end() || id == s.tag_ids.end()) return false;
+    return Test(s.bitmaps[id->second], entry->second);
+  }
+
+  /// Returns the named attribute of the function registered under `key`
+  static std::optional<double> Attribute(const Key& key,
+                                         const std::string& attribute) {
+    const State& s = state();
+    auto entry = s.index.find(key);
+    auto id = s.attribute_ids.find(attribute);
+    if (entry == s.index.end() || id == s.attribute_ids.end()) {
+      return std::nullopt;
+    }
+    double value = s.columns[id->second][entry->second];
+    if (value != value) return std::nullopt;  // kMissing
+    return value;
+  }
+
+  /** Returns the keys of all entries matching the query, in no particular
+   *  order. Repeated queries are served from a cache.
+   */
+  static selection_t Select(const TagQuery& query) {
+    State& s = state();
+    std::string signature = Signature(query);
+    {
+      std::lock_guard<std::mutex> lock(s.cache_mutex);
+      auto it = s.cache.find(signature);
+      if (it != s.cache.end()) return it->second;
+    }
+
+    selection_t result = Evaluate(s, query);
+    std::lock_guard<std::mutex> lock(s.cache_mutex);
+    if (s.cache.size() >= kMaxCachedQueries) s.cache.clear();
+    s.cache.emplace(std::move(signature), result);
+    return result;
+  }
+
+  /// Returns the keys of all entries that have every one of the given tags
+  static selection_t Select(std::initializer_list<std::string> tags_all) {
+    TagQuery query;
+    query.all = tags_all;
+    return Select(query);
+  }
+
+ private:
+  using word_t = std::uint64_t;
+  using bitmap_t = std::vector<word_t>;
+
+  static constexpr std::size_t kWordBits = 64;
+
+  // Bounds the number of query results cached by Select().
+  static constexpr std::size_t kMaxCachedQueries = 1024;
+  static constexpr double kMissing = std::numeric_limits<double>::quiet_NaN();
+
+  struct State {
+    // Dense entry arrays; index maps a key to its position.
+    std::unordered_map<Key, std::size_t, Hash, KeyEqual> index;
+    std::vector<Key> keys;
+    std::vector<func_t> funcs;
+
+    std::unordered_map<std::string, std::size_t> tag_ids;
+    std::vector<bitmap_t> bitmaps;  // Per tag, one bit per entry
+
+    std::unordered_map<std::string, std::size_t> attribute_ids;
+    std::vector<std::vector<double>> columns;  // Per attribute, per entry
+
+    std::mutex cache_mutex;
+    std::unordered_map<std::string, selection_t> cache;
+  };
+
+  static State& state() {
+    static State s;
+    return s;
+  }
+
+  static std::size_t Words(std::size_t entries) {
+    return (entries + kWordBits - 1) / kWordBits;
+  }
+  static void Set(bitmap_t& b, std::size_t i) {
+    b[i / kWordBits] |= word_t(1) << (i % kWordBits);
+  }
+  static void Clear(bitmap_t& b, std::size_t i) {
+    b[i / kWordBits] &= ~(word_t(1) << (i % kWordBits));
+  }
+  static bool Test(const bitmap_t& b, std::size_t i) {
+    return (b[i / kWordBits] >> (i % kWordBits)) & 1u;
+  }
+
+  static std::size_t TagId(State& s, const std::string& tag) {
+    auto inserted = s.tag_ids.emplace(tag, s.bitmaps.size());
+    if (inserted.second) s.bitmaps.emplace_back(Words(s.keys.size()), 0);
+    return inserted.first->second;
+  }
+
+  static std::size_t AttributeId(State& s, const std::string& attribute) {
+    auto inserted = s.attribute_ids.emplace(attribute, s.columns.size());
+    if (inserted.second) s.columns.emplace_back(s.keys.size(), kMissing);
+    return inserted.first->second;
+  }
+
+  static void ClearCache(State& s) {
+    std::lock_guard<std::mutex> lock(s.cache_mutex);
+    s.cache.clear();
+  }
+
+  /// Canonical cache key of a query, independent of the order of its tags
+  static std::string Signature(const TagQuery& query) {
+    std::string signature;
+    auto append = [&signature](char kind, std::vector<std::string> tags) {
+      std::sort(tags.begin(), tags.end());
+      for (const std::string& tag : tags) {
+        signature += kind;
+        signature += std::to_string(tag.size());
+        signature += ':';
+        signature += tag;
+      }
+    };
+    append('&', query.all);
+    append('|', query.any);
+    append('!', query.none);
+    for (const TagQuery::Range& range : query.ranges) {
+      signature += '#' + std::to_string(range.attribute.size()) + ':' +
+                   range.attribute + '[';
+      AppendBits(&signature, range.min);
+      signature += ',';
+      AppendBits(&signature, range.max);
+      signature += ']';
+    }
+    return signature;
+  }
+
+  /// Appends the exact bit pattern of `value`, so close bounds stay distinct
+  static void AppendBits(std::string* signature, double value) {
+    if (value == 0) value = 0;  // -0.0 and 0.0 select the same entries
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    signature->append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+  }
+
+  static selection_t Evaluate(const State& s, const TagQuery& query) {
+    const std::size_t n = s.keys.size();
+    const std::size_t words = Words(n);
+    auto result = std::make_shared<std::vector<Key>>();
+
+    bitmap_t mask(words, ~word_t(0));
+    if (n % kWordBits != 0) {
+      mask[words - 1] = (word_t(1) << (n % kWordBits)) - 1;
+    }
+
+    for (const std::string& tag : query.all) {
+      auto id = s.tag_ids.find(tag);
+      if (id == s.tag_ids.end()) return result;
+      const bitmap_t& b = s.bitmaps[id->second];
+      for (std::size_t w = 0; w < words; ++w) mask[w] &= b[w];
+    }
+    if (!query.any.empty()) {
+      bitmap_t any(words, 0);
+      for (const std::string& tag : query.any) {
+        auto id = s.tag_ids.find(tag);
+        if (id == s.tag_ids.end()) continue;
+        const bitmap_t& b = s.bitmaps[id->second];
+        for (std::size_t w = 0; w < words; ++w) any[w] |= b[w];
+      }
+      for (std::size_t w = 0; w < words; ++w) mask[w] &= any[w];
+    }
+    for (const std::string& tag : query.none) {
+      auto id = s.tag_ids.find(tag);
+      if (id == s.tag_ids.end()) continue;
+      const bitmap_t& b = s.bitmaps[id->second];
+      for (std::size_t w = 0; w < words; ++w) mask[w] &= ~b[w];
+    }
+
+    std::vector<const std::vector<double>*> columns;
+    for (const TagQuery::Range& range : query.ranges) {
+      auto id = s.attribute_ids.find(range.attribute);
+      if (id == s.attribute_ids.end()) return result;
+      columns.push_back(&s.columns[id->second]);
+    }
+
+    for (std::size_t w = 0; w < words; ++w) {
+      for (word_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+        std::size_t i = w * kWordBits + CountTrailingZeros(bits);
+        bool in_range = true;
+        for (std::size_t r = 0; r < columns.size() && in_range; ++r) {
+          double value = (*columns[r])[i];
+          // NaN (a missing attribute) fails both comparisons.
+          in_range = value >= query.ranges[r].min &&
+                     value <= query.ranges[r].max;
+        }
+        if (in_range) result->push_back(s.keys[i]);
+      }
+    }
+    return result;
+  }
+
+  static std::size_t CountTrailingZeros(word_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+    std::size_t n = 0;
+    while ((bits & 1u) == 0) {
+      bits >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+};
+
+}
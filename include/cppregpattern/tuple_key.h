@@ -0,0 +1,151 @@
+/** Hashing and equality functors for compound (tuple and struct) keys
+ *
+ *  \file tuple_key.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace registry {
+
+/** Mixes the hash value `h` into the running hash `seed`.
+ *
+ *  \param seed  Hash of the components seen so far
+ *  \param h     Hash of the next component
+ *
+ *  \return The combined hash
+ */
+inline std::size_t HashCombine(std::size_t seed, std::size_t h) {
+  return seed ^ (h + std::size_t(0x9e3779b97f4a7c15ULL) + (seed << 6) +
+                 (seed >> 2));
+}
+
+namespace detail {
+
+template <class T>
+using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <class T>
+struct is_string_like
+    : std::integral_constant<
+          bool, std::is_convertible<const T&, std::string_view>::value &&
+                    !std::is_same<T, std::nullptr_t>::value> {};
+
+/// Hashes one key component. String-like components hash through
+/// std::string_view and integral/enum components through their value, so an
+/// owned key and a key made of views/narrower integers hash the same.
+template <class T>
+std::size_t HashComponent(const T& value) {
+  if constexpr (is_string_like<T>::value) {
+    return std::hash<std::string_view>()(std::string_view(value));
+  } else if constexpr (std::is_enum<T>::value) {
+    using underlying_t = std::underlying_type_t<T>;
+    return std::hash<std::uint64_t>()(
+        static_cast<std::uint64_t>(static_cast<underlying_t>(value)));
+  } else if constexpr (std::is_integral<T>::value) {
+    return std::hash<std::uint64_t>()(static_cast<std::uint64_t>(value));
+  } else {
+    return std::hash<T>()(value);
+  }
+}
+
+template <class A, class B>
+bool ComponentEqual(const A& a, const B& b) {
+  if constexpr (is_string_like<A>::value && is_string_like<B>::value) {
+    return std::string_view(a) == std::string_view(b);
+  } else {
+    return a == b;
+  }
+}
+
+// Struct keys opt in by providing a `KeyTie(const S&)` function, found by
+// ADL, that returns a std::tie() of their members. Tuple-like keys (tuple,
+// pair, array) are used as they are.
+template <class T>
+auto AsTuple(const T& key, int) -> decltype(KeyTie(key)) {
+  return KeyTie(key);
+}
+
+template <class T>
+const T& AsTuple(const T& key, long) {
+  return key;
+}
+
+template <class Tuple, std::size_t... I>
+std::size_t HashTuple(const Tuple& t, std::index_sequence<I...>) {
+  std::size_t seed = 0;
+  ((seed = HashCombine(
+        seed, HashComponent<remove_cvref_t<std::tuple_element_t<I, Tuple>>>(
+                  std::get<I>(t)))),
+   ...);
+  return seed;
+}
+
+template <class TupleA, class TupleB, std::size_t... I>
+bool TupleEqual(const TupleA& a, const TupleB& b, std::index_sequence<I...>) {
+  return (ComponentEqual(std::get<I>(a), std::get<I>(b)) && ...);
+}
+
+}
+
+/** Hash functor for tuple-like and struct keys
+ *
+ *  \par
+ *  Each component is hashed and the results are combined with HashCombine().
+ *  The functor is transparent: a `std::tuple<std::string_view, int, Enum>`
+ *  hashes identically to the stored `std::tuple<std::string, int, Enum>`, so
+ *  a Registry using TupleHash and TupleEqual can be dispatched with a tuple
+ *  of views without building an owned key:
+ *
+ *  \code{.cpp}
+ *  using CodecKey = std::tuple<std::string, int, Flavor>;
+ *  using CodecRegistry =
+ *      Registry<CodecKey, std::unique_ptr<Codec>(),
+ *               MissingKeyPolicy::exception, TupleHash, TupleEqual>;
+ *  CodecRegistry::Dispatch(std::make_tuple(std::string_view("png"), 3,
+ *                                          Flavor::fast));
+ *  \endcode
+ *
+ *  Struct keys are supported by declaring a `KeyTie` function next to the
+ *  struct that returns a `std::tie()` of its members.
+ */
+struct TupleHash {
+  using is_transparent = void;
+
+  template <class Key>
+  std::size_t operator()(const Key& key) const {
+    const auto& t = detail::AsTuple(key, 0);
+    using tuple_t = detail::remove_cvref_t<decltype(t)>;
+    return detail::HashTuple(
+        t, std::make_index_sequence<std::tuple_size<tuple_t>::value>());
+  }
+};
+
+/// Transparent component-wise equality functor to pair with TupleHash
+struct TupleEqual {
+  using is_transparent = void;
+
+  template <class KeyA, class KeyB>
+  bool operator()(const KeyA& a, const KeyB& b) const {
+    const auto& ta = detail::AsTuple(a, 0);
+    const auto& tb = detail::AsTuple(b, 0);
+    using tuple_a = detail::remove_cvref_t<decltype(ta)>;
+    using tuple_b = detail::remove_cvref_t<decltype(tb)>;
+    static_assert(
+        std::tuple_size<tuple_a>::value == std::tuple_size<tuple_b>::value,
+        "compound keys must have the same number of components");
+    return detail::TupleEqual(
+        ta, tb, std::make_index_sequence<std::tuple_size<tuple_a>::value>());
+  }
+};
+
+}
@@ -0,0 +1,175 @@
+/** Interface file for the UniqueFunction class template
+ *
+ *  \file unique_function.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace registry {
+
+template <class Sig, std::size_t InlineSize = 3 * sizeof(void*),
+          class Alloc = std::allocator<unsigned char>>
+class UniqueFunction;
+
+/** A move-only counterpart of `std::function`, usable as the `Func`
+ *  parameter of BasicRegistry and Registry to register callables that own
+ *  move-only state such as a `std::unique_ptr`.
+ *
+ *  \par
+ *  Targets of at most `InlineSize` bytes that are nothrow-movable are stored
+ *  inline; larger ones are allocated with `Alloc`, rebound to the target
+ *  type. BasicRegistry::Emplace() passes the registry's allocator, so that
+ *  all callable storage of a registry comes from one allocator.
+ *
+ *  \code{.cpp}
+ *  using Jobs = BasicRegistry<std::string, UniqueFunction<void()>>;
+ *  Jobs jobs;
+ *  auto buffer = std::make_unique<Buffer>();
+ *  jobs.Register("flush", [b = std::move(buffer)] { b->Flush(); });
+ *  \endcode
+ *
+ *  \tparam InlineSize  Size of the inline buffer in bytes
+ *  \tparam Alloc       Allocator for targets that do not fit inline
+ */
+template <class R, class... Args, std::size_t InlineSize, class Alloc>
+class UniqueFunction<R(Args...), InlineSize, Alloc> {
+  template <class F>
+  using enable_target = typename std::enable_if<
+      !std::is_same<typename std::decay<F>::type, UniqueFunction>::value &&
+      !std::is_same<typename std::decay<F>::type, std::nullptr_t>::value>::type;
+
+ public:
+  using result_type = R;
+  using allocator_type = Alloc;
+
+  UniqueFunction() noexcept {}
+  UniqueFunction(std::nullptr_t) noexcept {}  // NOLINT: like std::function
+
+  template <class F, class = enable_target<F>>
+  UniqueFunction(F&& func)  // NOLINT: implicit like std::function
+      : UniqueFunction(std::allocator_arg, Alloc(), std::forward<F>(func)) {}
+
+  /// Constructs the target from `func`, allocating it with `alloc` if it
+  /// does not fit inline
+  template <class F, class = enable_target<F>>
+  UniqueFunction(std::allocator_arg_t, const Alloc& alloc, F&& func)
+      : alloc_(alloc) {
+    using T = typename std::decay<F>::type;
+    if constexpr (Inline<T>()) {
+      target_ = ::new (static_cast<void*>(storage_)) T(std::forward<F>(func));
+    } else {
+      target_alloc_t<T> a(alloc_);
+      T* p = std::allocator_traits<target_alloc_t<T>>::allocate(a, 1);
+      try {
+        ::new (static_cast<void*>(p)) T(std::forward<F>(func));
+      } catch (...) {
+        std::allocator_traits<target_alloc_t<T>>::deallocate(a, p, 1);
+        throw;
+      }
+      target_ = p;
+    }
+    ops_ = &Ops<T>::table;
+  }
+
+  UniqueFunction(UniqueFunction&& other) noexcept : alloc_(other.alloc_) {
+    MoveFrom(other);
+  }
+
+  UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      alloc_ = other.alloc_;
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  UniqueFunction(const UniqueFunction&) = delete;
+  UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+  ~UniqueFunction() { Reset(); }
+
+  explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+  /// Calls the target; throws std::bad_function_call if there is none
+  R operator()(Args... args) const {
+    if (ops_ == nullptr) throw std::bad_function_call();
+    return ops_->invoke(target_, std::forward<Args>(args)...);
+  }
+
+  allocator_type get_allocator() const { return alloc_; }
+
+ private:
+  template <class T>
+  using target_alloc_t =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+  struct OpsTable {
+    R (*invoke)(void*, Args&&...);
+    void (*relocate)(void*, void*);  // Inline targets only
+    void (*destroy)(void*, Alloc&, bool);
+  };
+
+  template <class T>
+  static constexpr bool Inline() {
+    return sizeof(T) <= InlineSize &&
+           alignof(T) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible<T>::value;
+  }
+
+  template <class T>
+  struct Ops {
+    static R Invoke(void* target, Args&&... args) {
+      return (*static_cast<T*>(target))(std::forward<Args>(args)...);
+    }
+    static void Relocate(void* dst, void* src) {
+      ::new (dst) T(std::move(*static_cast<T*>(src)));
+      static_cast<T*>(src)->~T();
+    }
+    static void Destroy(void* target, Alloc& alloc, bool on_heap) {
+      static_cast<T*>(target)->~T();
+      if (on_heap) {
+        target_alloc_t<T> a(alloc);
+        std::allocator_traits<target_alloc_t<T>>::deallocate(
+            a, static_cast<T*>(target), 1);
+      }
+    }
+    static constexpr OpsTable table = {&Invoke, &Relocate, &Destroy};
+  };
+
+  bool OnHeap() const { return target_ != static_cast<const void*>(storage_); }
+
+  void MoveFrom(UniqueFunction& other) noexcept {
+    ops_ = other.ops_;
+    if (ops_ == nullptr) return;
+    if (other.OnHeap()) {
+      target_ = other.target_;
+    } else {
+      ops_->relocate(storage_, other.storage_);
+      target_ = storage_;
+    }
+    other.ops_ = nullptr;
+    other.target_ = nullptr;
+  }
+
+  void Reset() noexcept {
+    if (ops_ != nullptr) ops_->destroy(target_, alloc_, OnHeap());
+    ops_ = nullptr;
+    target_ = nullptr;
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[InlineSize];
+  void* target_ = nullptr;
+  const OpsTable* ops_ = nullptr;
+  Alloc alloc_;
+};
+
+}
@@ -0,0 +1,289 @@
+/** Profile-driven warm-up of registry entries
+ *
+ *  \file warm_up.h
+ *  \date 18 Oct 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cppregpattern/key_codec.h"
+#include "cppregpattern/registry.h"
+
+namespace registry {
+
+namespace detail {
+
+constexpr char kKeyProfileMagic[8] = {'C', 'R', 'P', 'K', 'P', 'R', 'F', 0};
+constexpr std::uint32_t kKeyProfileFormat = 1;
+
+/// Layout of a profile file: the header, then for each key its size as a
+/// std::uint64_t followed by its KeyCodec bytes
+struct KeyProfileHeader {
+  char magic[8];
+  std::uint32_t format;
+  std::uint32_t reserved;
+  std::uint64_t key_count;
+};
+
+}
+
+/** Records the distinct keys dispatched during the first part of a run, in
+ *  the order they were first seen, so that the next run can warm them up
+ *  with WarmUp() before taking traffic.
+ *
+ *  \par
+ *  Recording stops after `window` or `max_keys` distinct keys, whichever
+ *  comes first; from then on Record() costs one relaxed atomic load. While
+ *  recording, it takes a mutex, so it is meant for the start-up phase only.
+ *
+ *  \code{.cpp}
+ *  KeyProfile<std::string> profile(std::chrono::minutes(1));
+ *  // On the request path:
+ *  profile.Dispatch(Handlers::Instance(), key, request);
+ *  // Once recording is over, e.g. from a timer:
+ *  profile.Save("/var/lib/service/handlers.profile");
+ *  \endcode
+ *
+ *  \tparam Key  The identifier type, with a KeyCodec specialisation
+ */
+template <class Key, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class KeyProfile {
+ public:
+  using clock = std::chrono::steady_clock;
+  using codec_t = KeyCodec<Key>;
+
+  explicit KeyProfile(clock::duration window = std::chrono::minutes(1),
+                      std::size_t max_keys = 4096)
+      : deadline_(clock::now() + window), max_keys_(max_keys) {}
+
+  KeyProfile(const KeyProfile&) = delete;
+  KeyProfile& operator=(const KeyProfile&) = delete;
+
+  /// Notes a dispatch of `key` if still recording
+  void Record(const Key& key) {
+    if (!recording_.load(std::memory_order_relaxed)) return;
+    if (clock::now() >= deadline_) {
+      Stop();
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (seen_.size() >= max_keys_ || !seen_.insert(key).second) return;
+    keys_.push_back(key);
+    if (keys_.size() == max_keys_) Stop();
+  }
+
+  /// Records `key`, then calls `registry.Dispatch(key, args...)`
+  template <class Registry, class... Args>
+  decltype(auto) Dispatch(Registry& registry, const Key& key,
+                          Args&&... args) {
+    Record(key);
+    return registry.Dispatch(key, std::forward<Args>(args)...);
+  }
+
+  /// Ends recording early
+  void Stop() { recording_.store(false, std::memory_order_relaxed); }
+
+  /// Whether Record() still collects keys
+  bool recording() const {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  /// The recorded keys, in the order they were first seen
+  std::vector<Key> keys() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_;
+  }
+
+  /** Writes the recorded keys to `path`, replacing any previous profile
+   *  atomically
+   *
+   *  \throws std::runtime_error if the file cannot be written
+   */
+  void Save(const std::string& path) const {
+    std::vector<Key> keys = this->keys();
+    detail::KeyProfileHeader header;
+    std::memcpy(header.magic, detail::kKeyProfileMagic, sizeof(header.magic));
+    header.format = detail::kKeyProfileFormat;
+    header.reserved = 0;
+    header.key_count = keys.size();
+
+    std::string tmp = path + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (const Key& key : keys) {
+        KeyBytes bytes = codec_t::Encode(key);
+        std::uint64_t size = bytes.size;
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(static_cast<const char*>(bytes.data),
+                  static_cast<std::streamsize>(bytes.size));
+      }
+      if (!out) {
+        throw std::runtime_error("registry::KeyProfile::Save: cannot write " +
+                                 tmp);
+      }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      throw std::runtime_error("registry::KeyProfile::Save: cannot replace " +
+                               path);
+    }
+  }
+
+  /** Reads the keys saved by Save(). A missing, truncated or foreign file
+   *  yields no keys, since the first run after a deploy has no profile yet.
+   */
+  static std::vector<Key> Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    detail::KeyProfileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, detail::kKeyProfileMagic,
+                    sizeof(header.magic)) != 0 ||
+        header.format != detail::kKeyProfileFormat) {
+      return {};
+    }
+    std::vector<Key> keys;
+    std::string bytes;
+    for (std::uint64_t i = 0; i < header.key_count; ++i) {
+      std::uint64_t size = 0;
+      if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+          size > (1u << 20)) {
+        return {};
+      }
+      bytes.resize(static_cast<std::size_t>(size));
+      Key key{};
+      if (!in.read(&bytes[0], static_cast<std::streamsize>(size)) ||
+          !codec_t::Decode(bytes.data(), bytes.size(), &key)) {
+        return {};
+      }
+      keys.push_back(std::move(key));
+    }
+    return keys;
+  }
+
+ private:
+  const clock::time_point deadline_;
+  const std::size_t max_keys_;
+  std::atomic<bool> recording_{true};
+  mutable std::mutex mutex_;
+  std::unordered_set<Key, Hash, KeyEqual> seen_;
+  std::vector<Key> keys_;
+};
+
+/// Outcome of WarmUp()
+struct WarmUpReport {
+  std::size_t warmed = 0;   ///< Keys passed to the warm-up function
+  std::size_t missing = 0;  ///< Keys no longer registered
+  std::size_t failed = 0;   ///< Keys whose warm-up function threw
+};
+
+/** Warm-up function that only reads the stored function object of a key,
+ *  paging in the registry's table and the object itself without running
+ *  it. The code of the function is not touched, so it is neither paged in
+ *  nor brought into the instruction cache, and lazy entries stay
+ *  unresolved; pass a warm function that dispatches the key for that.
+ *  Registries must provide Find(), like BasicRegistry.
+ */
+struct TouchEntry {
+  template <class Registry, class Key>
+  void operator()(Registry& registry, const Key& key) const {
+    const auto* func = registry.Find(key);
+    if (func == nullptr) return;
+    const volatile unsigned char* bytes =
+        reinterpret_cast<const volatile unsigned char*>(func);
+    unsigned char sink = 0;
+    for (std::size_t i = 0; i < sizeof(*func); ++i) sink ^= bytes[i];
+    static_cast<void>(sink);
+  }
+};
+
+#if __cplusplus >= 201703L
+#define CPPREGPATTERN_WARM_UP_NODISCARD [[nodiscard]]
+#else
+#define CPPREGPATTERN_WARM_UP_NODISCARD
+#endif
+
+/** Calls `warm(registry, key)` for each registered key of `keys` (e.g. from
+ *  KeyProfile::Load()) on `threads` background threads, in profile order.
+ *  `warm` typically dispatches the key with sample arguments, which also
+ *  runs lazy initializers (see BasicRegistry::RegisterLazy()); its results
+ *  and exceptions are discarded, and it may run on several threads at once.
+ *  If a helper thread cannot be started, the warm-up goes on with the
+ *  threads it has. Wait for the returned future before reporting ready;
+ *  `registry` must outlive it. The future comes from std::async, so its
+ *  destructor blocks until the warm-up is over: discarding the result runs
+ *  the warm-up synchronously.
+ *
+ *  \code{.cpp}
+ *  auto done = WarmUp(Handlers::Instance(),
+ *                     KeyProfile<std::string>::Load(kProfilePath),
+ *                     [](auto& handlers, const std::string& key) {
+ *                       handlers.Dispatch(key, SampleRequest(key));
+ *                     }, 4);
+ *  done.wait();
+ *  ReportReady();
+ *  \endcode
+ */
+template <class Registry, class Key, class Warm = TouchEntry>
+CPPREGPATTERN_WARM_UP_NODISCARD std::future<WarmUpReport> WarmUp(
+    Registry& registry, std::vector<Key> keys, Warm warm = Warm(),
+    unsigned threads = 1) {
+  return std::async(
+      std::launch::async,
+      [&registry, threads](std::vector<Key> todo, Warm warm_key) {
+        std::atomic<std::size_t> next(0), warmed(0), missing(0), failed(0);
+        auto work = [&] {
+          for (std::size_t i = next++; i < todo.size(); i = next++) {
+            if (!registry.IsRegistered(todo[i])) {
+              ++missing;
+              continue;
+            }
+            try {
+              warm_key(registry, todo[i]);
+              ++warmed;
+            } catch (...) {
+              ++failed;
+            }
+          }
+        };
+        std::vector<std::thread> helpers;
+        unsigned count = std::max(1u, threads);
+        helpers.reserve(count - 1);
+        try {
+          for (unsigned t = 1; t < count; ++t) helpers.emplace_back(work);
+        } catch (const std::system_error&) {
+          // Out of threads: the helpers already started and this thread
+          // share the keys
+        }
+        work();
+        for (std::thread& helper : helpers) helper.join();
+        WarmUpReport report;
+        report.warmed = warmed;
+        report.missing = missing;
+        report.failed = failed;
+        return report;
+      },
+      std::move(keys), std::move(warm));
+}
+
+}
@@ -0,0 +1,74 @@
+/** C++20 module interface of the library
+ *
+ *  \file cppregpattern.cppm
+ *  \date 18 Oct 2026
+ *
+ *  `import cppregpattern;` provides the registries that only need the
+ *  standard library. The POSIX-specific headers (replicated_registry.h,
+ *  frozen_registry.h, shared_key_index.h, registry_image.h, memo_cache.h,
+ *  warm_up.h, c_abi.h) and the macros of anchor.h and rt_verify.h are used
+ *  through `#include` as before. Build it with the CMake option
+ *  CPPREGPATTERN_BUILD_MODULE.
+ */
+
+module;
+
+#include "cppregpattern/delegate.h"
+#include "cppregpattern/family_registry.h"
+#include "cppregpattern/fixed_registry.h"
+#include "cppregpattern/hetero_registry.h"
+#include "cppregpattern/inline_cache.h"
+#include "cppregpattern/interval_registry.h"
+#include "cppregpattern/overlay_registry.h"
+#include "cppregpattern/registry.h"
+#include "cppregpattern/tagged_registry.h"
+#include "cppregpattern/tuple_key.h"
+#include "cppregpattern/unique_function.h"
+
+export module cppregpattern;
+
+export namespace registry {
+
+// registry.h
+using registry::BasicRegistry;
+using registry::MissingKeyPolicy;
+using registry::NoLockPolicy;
+using registry::Registry;
+using registry::SharedMutexPolicy;
+
+// Callable types
+using registry::Delegate;
+using registry::InplaceFunction;
+using registry::UniqueFunction;
+
+// Registry variants
+using registry::CachedRegistry;
+using registry::FixedRegisterStatus;
+using registry::FixedRegistry;
+using registry::FixedString;
+using registry::HeteroRegistry;
+using registry::InlineCacheStats;
+using registry::IntervalRegistry;
+using registry::KeyFamilyRegistry;
+using registry::KeyParams;
+using registry::Metadata;
+using registry::OverlapPolicy;
+using registry::OverlayRegistry;
+using registry::signature_id_t;
+using registry::TaggedRegistry;
+using registry::TagQuery;
+using registry::ToString;
+using registry::TupleEqual;
+using registry::TupleHash;
+
+namespace rt {
+using registry::rt::AbortOnViolation;
+using registry::rt::Check;
+using registry::rt::Report;
+using registry::rt::SetViolationHandler;
+using registry::rt::ToString;
+using registry::rt::Violation;
+using registry::rt::ViolationHandler;
+}
+
+}